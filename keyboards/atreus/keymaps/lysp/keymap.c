@@ -1,5 +1,8 @@
 #include QMK_KEYBOARD_H
 
+#include "miryoku_output.h"
+#include "miryoku_tap_dance.h"
+
 #define _QW 0
 #define _RS 1
 #define _LW 2
@@ -14,7 +17,7 @@ enum {
 // Tap Dance definitions
 tap_dance_action_t tap_dance_actions[] = {
     // Tap once for semi-colon, twice for F19 (for use with Hyper key)
-    [TD_SCLN] = ACTION_TAP_DANCE_DOUBLE(KC_SCLN, KC_F19),
+    [TD_SCLN] = ACTION_TAP_DANCE_SPECULATIVE(KC_SCLN, KC_F19),
 };
 
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
@@ -59,3 +62,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______ ),
 
 };
+
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return u_output_pre_process(record);
+}
+
+void housekeeping_task_user(void) {
+    u_output_task();
+}
@@ -1,2 +1,7 @@
 CAPS_WORD_ENABLE = yes
 TAP_DANCE_ENABLE = yes
+
+# speculative tap dance and the output queue it sends through, from the
+# miryoku userspace
+VPATH += $(QMK_USERSPACE)/users/manna-harbour_miryoku
+SRC += miryoku_output.c miryoku_tap_dance.c
@@ -1,9 +1 @@
 #include QMK_KEYBOARD_H
-
-const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
-    LAYOUT(
-        'L', 'L', 'L', 'L', 'L',            'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L',            'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L',            'R', 'R', 'R', 'R', 'R',
-        '*', '*', '*', 'L', 'L', 'L',  'R', 'R', 'R', '*', '*', '*'
-    );
@@ -5,6 +5,8 @@
 
 #include QMK_KEYBOARD_H
 #include "manna-harbour_miryoku.h"
+#include "miryoku_output.h"
+#include "miryoku_mouse.h"
 
 // CRKBD-specific platform-agnostic user codes for encoder behavior
 // Browser navigation and app/tab switching that adapts to the current platform:
@@ -65,47 +67,174 @@
 // - Windows/Linux: Media keys for browser, ALT for apps, CTRL for tabs
 //
 // Function Usage:
-// - tap_code(): Basic keycodes (volume, scroll, navigation)
-// - tap_code16(): Keycodes with modifiers (shortcuts, app switching)
+// - u_output_tap(): Keycodes, with or without modifiers, sent from the output queue
+//   so fast spins never stall matrix scanning
+// - u_output_register_mods()/u_output_unregister_mods(): Held modifiers, kept in
+//   order with the queued taps
 // - Direct RGB functions: Immediate visual feedback
 
 // App/window switching timeout (milliseconds)
 // How long to wait after the last encoder rotation before releasing modifier
 #define WINDOW_SWITCH_TIMEOUT_MS 500
 
-// State tracking for app/tab switching with held modifiers
+// Encoder proxy layers - activated automatically by QMK's LT functionality
+enum custom_encoder_layers {
+    U_ENC_LEFT = U_FUN + 1,     // Proxy layer activated by LT(U_ENC_LEFT, KC_ENT) - left encoder button
+    U_ENC_RIGHT,                // Proxy layer activated by LT(U_ENC_RIGHT, KC_SPC) - right encoder button
+};
+
+// Encoders supported by rev4.1, and the proxy layer of each encoder's button
+#define ENCODER_COUNT 4
+#define ENCODER_NO_BUTTON 0xFF
+
+static const uint8_t encoder_button_layers[ENCODER_COUNT] = {
+    U_ENC_LEFT,        // 0: left top
+    ENCODER_NO_BUTTON, // 1
+    U_ENC_RIGHT,       // 2: right top
+    ENCODER_NO_BUTTON, // 3
+};
+
+// Encoder action table
+//
+// encoder_actions[layer][encoder][button held][direction], built from one
+// ENCODER_ACTIONS_<LAYER> row per Miryoku layer through MIRYOKU_X. Each row
+// lists the four encoders as {normal, button held} pairs of actions, and each
+// action expands to its {counter-clockwise, clockwise} entries. With the
+// button held the layer is the one active when the button was pressed.
+//
+// Action types:
+// - ENC_KEY(cw, ccw): Tap once per detent (switching, undo, tracks)
+// - ENC_MOVE(cw, ccw): Tap once per accelerated step (volume, cursor, paging)
+// - ENC_SCROLL_V, ENC_SCROLL_H: Scroll by accelerated steps
+// - ENC_SESSION(mods, cw, ccw): Hold mods while tapping once per detent, until
+//   the layer changes
+// - ENC_SESSION_TIMEOUT(mods, cw, ccw): As ENC_SESSION, also ended after
+//   WINDOW_SWITCH_TIMEOUT_MS without rotation
+// - ENC_RGB(cw, ccw): Call an RGB matrix function once per detent
+typedef enum {
+    ENC_TYPE_NONE,
+    ENC_TYPE_KEY,
+    ENC_TYPE_MOVE,
+    ENC_TYPE_SCROLL_V,
+    ENC_TYPE_SCROLL_H,
+    ENC_TYPE_SESSION,
+    ENC_TYPE_SESSION_TIMEOUT,
+    ENC_TYPE_RGB,
+} encoder_action_type_t;
+
 typedef struct {
-    bool window_switching_active;    // Alt modifier held for window switching on NUM layer (no timeout)
-    bool num_window_switching_active; // Platform modifier held for window management on NUM layer (button held)
-    bool app_switching_active;       // Platform modifier held for app switching on Base layer (with timeout)
-    bool tab_switching_active;       // CTRL held for tab switching on SYM layer
+    uint8_t  type; // encoder_action_type_t
+    uint8_t  mods; // held by sessions
+    uint16_t arg;  // keycode, or encoder_rgb_t for ENC_TYPE_RGB
+} encoder_action_t;
+
+typedef enum {
+    ENC_RGB_STEP,
+    ENC_RGB_STEP_REVERSE,
+    ENC_RGB_VAL_UP,
+    ENC_RGB_VAL_DOWN,
+    ENC_RGB_SPEED_UP,
+    ENC_RGB_SPEED_DOWN,
+    ENC_RGB_HUE_UP,
+    ENC_RGB_HUE_DOWN,
+} encoder_rgb_t;
+
+static void (*const encoder_rgb_functions[])(void) = {
+    [ENC_RGB_STEP]         = rgb_matrix_step,
+    [ENC_RGB_STEP_REVERSE] = rgb_matrix_step_reverse,
+    [ENC_RGB_VAL_UP]       = rgb_matrix_increase_val,
+    [ENC_RGB_VAL_DOWN]     = rgb_matrix_decrease_val,
+    [ENC_RGB_SPEED_UP]     = rgb_matrix_increase_speed,
+    [ENC_RGB_SPEED_DOWN]   = rgb_matrix_decrease_speed,
+    [ENC_RGB_HUE_UP]       = rgb_matrix_increase_hue,
+    [ENC_RGB_HUE_DOWN]     = rgb_matrix_decrease_hue,
+};
+
+#define ENC_ACTION(TYPE, MODS, CW, CCW) {{TYPE, MODS, CCW}, {TYPE, MODS, CW}}
+#define ENC_NONE ENC_ACTION(ENC_TYPE_NONE, 0, KC_NO, KC_NO)
+#define ENC_KEY(CW, CCW) ENC_ACTION(ENC_TYPE_KEY, 0, CW, CCW)
+#define ENC_MOVE(CW, CCW) ENC_ACTION(ENC_TYPE_MOVE, 0, CW, CCW)
+#define ENC_SCROLL_V ENC_ACTION(ENC_TYPE_SCROLL_V, 0, KC_NO, KC_NO)
+#define ENC_SCROLL_H ENC_ACTION(ENC_TYPE_SCROLL_H, 0, KC_NO, KC_NO)
+#define ENC_SESSION(MODS, CW, CCW) ENC_ACTION(ENC_TYPE_SESSION, MODS, CW, CCW)
+#define ENC_SESSION_TIMEOUT(MODS, CW, CCW) ENC_ACTION(ENC_TYPE_SESSION_TIMEOUT, MODS, CW, CCW)
+#define ENC_RGB(CW, CCW) ENC_ACTION(ENC_TYPE_RGB, 0, CW, CCW)
+
+// Window switching within an app while the left encoder button is held on NUM
+#if defined(MIRYOKU_CLIPBOARD_MAC)
+  #define U_WIN_CW KC_GRV // CMD+` for window switching within the same app
+  #define U_WIN_CCW LSFT(KC_GRV)
+#else
+  #define U_WIN_CW KC_TAB // Alt+Tab for window switching
+  #define U_WIN_CCW LSFT(KC_TAB)
+#endif
+
+//                            Left encoder (0)                                                       Encoder 1             Right encoder (2)                                    Encoder 3
+#define ENCODER_ACTIONS_BASE   {{ENC_SESSION_TIMEOUT(U_APP_MOD, KC_TAB, LSFT(KC_TAB)), ENC_MOVE(KC_VOLU, KC_VOLD)}, {ENC_NONE, ENC_NONE}, {ENC_SCROLL_V, ENC_MOVE(KC_PGDN, KC_PGUP)}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_EXTRA  ENCODER_ACTIONS_BASE
+#define ENCODER_ACTIONS_TAP    ENCODER_ACTIONS_BASE
+#define ENCODER_ACTIONS_BUTTON {{ENC_KEY(U_FWD, U_BCK), ENC_MOVE(KC_VOLU, KC_VOLD)}, {ENC_NONE, ENC_NONE}, {ENC_KEY(U_RDO, U_UND), ENC_SCROLL_V}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_NAV    {{ENC_MOVE(KC_RGHT, KC_LEFT), ENC_MOVE(LCTL(KC_RGHT), LCTL(KC_LEFT))}, {ENC_NONE, ENC_NONE}, {ENC_KEY(U_RDO, U_UND), ENC_SCROLL_V}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_MOUSE  {{ENC_SCROLL_H, ENC_MOVE(KC_VOLU, KC_VOLD)}, {ENC_NONE, ENC_NONE}, {ENC_SCROLL_V, ENC_SCROLL_H}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_MEDIA  {{ENC_MOVE(KC_VOLU, KC_VOLD), ENC_MOVE(KC_VOLU, KC_VOLD)}, {ENC_NONE, ENC_NONE}, {ENC_MOVE(KC_VOLU, KC_VOLD), ENC_KEY(KC_MNXT, KC_MPRV)}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_NUM    {{ENC_SESSION(MOD_BIT(KC_LALT), KC_TAB, LSFT(KC_TAB)), ENC_SESSION(U_WIN_MOD, U_WIN_CW, U_WIN_CCW)}, {ENC_NONE, ENC_NONE}, {ENC_SCROLL_V, ENC_SCROLL_V}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_SYM    {{ENC_SESSION(U_TAB_MOD, KC_TAB, LSFT(KC_TAB)), ENC_KEY(LCTL(KC_TAB), LCTL(LSFT(KC_TAB)))}, {ENC_NONE, ENC_NONE}, {ENC_SCROLL_V, ENC_SCROLL_V}, {ENC_NONE, ENC_NONE}}
+#define ENCODER_ACTIONS_FUN    {{ENC_RGB(ENC_RGB_STEP, ENC_RGB_STEP_REVERSE), ENC_RGB(ENC_RGB_SPEED_UP, ENC_RGB_SPEED_DOWN)}, {ENC_NONE, ENC_NONE}, {ENC_RGB(ENC_RGB_VAL_UP, ENC_RGB_VAL_DOWN), ENC_RGB(ENC_RGB_HUE_UP, ENC_RGB_HUE_DOWN)}, {ENC_NONE, ENC_NONE}}
+
+static const encoder_action_t PROGMEM encoder_actions[][ENCODER_COUNT][2][2] = {
+#define MIRYOKU_X(LAYER, STRING) [U_##LAYER] = ENCODER_ACTIONS_##LAYER,
+MIRYOKU_LAYER_LIST
+#undef MIRYOKU_X
+};
+
+// Held modifier session state. A session holds its modifiers from its first
+// detent until the layer it started on is left, another session starts, or for
+// timeout sessions the timeout expires. Holding an encoder button keeps the
+// base layer, so the proxy layer does not end the session.
+typedef struct {
+    uint8_t mods;                    // Modifiers held, 0 when no session is active
+    uint8_t layer;                   // Base layer when the session started
     uint8_t base_layer;              // The base layer when encoder proxy layer was activated
 } encoder_state_t;
 
-static encoder_state_t enc_state = {false, false, false, false, 0};
+static encoder_state_t enc_state = {0, 0, 0};
 
 // Deferred execution token for window switching timeout
 static deferred_token window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
 
-// Timeout callback to release app switching modifier (Base layer)
-static uint32_t window_switch_timeout_callback(uint32_t trigger_time, void *cb_arg) {
-    if (enc_state.app_switching_active) {
-        unregister_mods(U_APP_MOD);
-        enc_state.app_switching_active = false;
+static uint8_t current_encoder_layer(layer_state_t state) {
+    return get_highest_layer(state | default_layer_state);
+}
+
+// Release the modifiers held by the encoder session and drop the pending timeout
+static void release_encoder_mods(void) {
+    if (window_switch_timeout_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(window_switch_timeout_token);
+        window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
     }
+    if (enc_state.mods) {
+        u_output_unregister_mods(enc_state.mods);
+        enc_state.mods = 0;
+    }
+}
+
+// Timeout callback to release the session modifiers
+static uint32_t window_switch_timeout_callback(uint32_t trigger_time, void *cb_arg) {
     window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
+    release_encoder_mods();
     return 0; // Don't repeat
 }
 
-// Encoder proxy layers - activated automatically by QMK's LT functionality
-enum custom_encoder_layers {
-    U_ENC_LEFT = U_FUN + 1,     // Proxy layer activated by LT(U_ENC_LEFT, KC_ENT) - left encoder button
-    U_ENC_RIGHT,                // Proxy layer activated by LT(U_ENC_RIGHT, KC_SPC) - right encoder button
-};
+// The host drops held keys over suspend, so forget the session rather than
+// leaving enc_state claiming a modifier that is no longer down on wakeup
+void suspend_power_down_user(void) {
+    u_output_clear();
+    release_encoder_mods();
+}
 
 layer_state_t layer_state_set_user(layer_state_t state) {
-    uint8_t highest = get_highest_layer(state);
-    uint8_t prev_highest = get_highest_layer(layer_state);
+    uint8_t highest = current_encoder_layer(state);
+    uint8_t prev_highest = current_encoder_layer(layer_state);
 
     // Capture base layer when entering an encoder proxy layer
     if (highest == U_ENC_LEFT || highest == U_ENC_RIGHT) {
@@ -115,297 +244,167 @@ layer_state_t layer_state_set_user(layer_state_t state) {
         }
     }
 
-    // Detect when we're entering the left encoder proxy layer (button pressed)
-    // Cancel the window switch timeout since we're now doing volume control
-    if (highest == U_ENC_LEFT && prev_highest != U_ENC_LEFT) {
-        if (window_switch_timeout_token != INVALID_DEFERRED_TOKEN) {
-            cancel_deferred_exec(window_switch_timeout_token);
-            window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
-        }
+    // End the session once the layer it started on is left, reading through
+    // the proxy layer to the base layer it was entered from
+    if (highest == U_ENC_LEFT || highest == U_ENC_RIGHT) {
+        highest = enc_state.base_layer;
     }
-
-    // Detect when we're exiting the left encoder proxy layer
-    if (prev_highest == U_ENC_LEFT && highest != U_ENC_LEFT) {
-        // Release window switch modifier if we were on Base/Extra/Tap when we entered
-        if ((enc_state.base_layer == U_BASE || enc_state.base_layer == U_EXTRA ||
-             enc_state.base_layer == U_TAP) && enc_state.window_switching_active) {
-            unregister_mods(MOD_BIT(KC_LALT));
-            enc_state.window_switching_active = false;
-        }
-        // Release NUM layer window switch modifier if we were on NUM when we entered
-        if (enc_state.base_layer == U_NUM && enc_state.num_window_switching_active) {
-            unregister_mods(U_WIN_MOD);
-            enc_state.num_window_switching_active = false;
-        }
+    if (enc_state.mods && highest != enc_state.layer) {
+        release_encoder_mods();
     }
 
-    // Release app switch modifier if not in Base/Extra/Tap layers
-    if (!layer_state_cmp(state, U_BASE) && !layer_state_cmp(state, U_EXTRA) &&
-        !layer_state_cmp(state, U_TAP) && enc_state.app_switching_active) {
-        unregister_mods(U_APP_MOD);
-        enc_state.app_switching_active = false;
-        // Cancel timeout when manually releasing via layer change
-        if (window_switch_timeout_token != INVALID_DEFERRED_TOKEN) {
-            cancel_deferred_exec(window_switch_timeout_token);
-            window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
-        }
-    }
+    return state;
+}
 
-    // Release window switch modifier if NUM layer is no longer active
-    if (!layer_state_cmp(state, U_NUM) && enc_state.window_switching_active) {
-        unregister_mods(MOD_BIT(KC_LALT));
-        enc_state.window_switching_active = false;
+// Start or continue a held modifier session on the given base layer
+static void hold_encoder_mods(uint8_t mods, uint8_t layer, bool timeout) {
+    if (enc_state.mods != mods || enc_state.layer != layer) {
+        release_encoder_mods();
+        u_output_register_mods(mods);
+        enc_state.mods  = mods;
+        enc_state.layer = layer;
     }
 
-    // Release NUM layer window management modifier if NUM layer is no longer active
-    if (!layer_state_cmp(state, U_NUM) && enc_state.num_window_switching_active) {
-        unregister_mods(U_WIN_MOD);
-        enc_state.num_window_switching_active = false;
+    // Cancel any existing timeout and schedule a new one
+    if (window_switch_timeout_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(window_switch_timeout_token);
+        window_switch_timeout_token = INVALID_DEFERRED_TOKEN;
     }
-
-    // Release tab switch modifier if SYM layer is no longer active
-    if (!layer_state_cmp(state, U_SYM) && enc_state.tab_switching_active) {
-        unregister_mods(U_TAB_MOD);
-        enc_state.tab_switching_active = false;
+    if (timeout) {
+        window_switch_timeout_token = defer_exec(WINDOW_SWITCH_TIMEOUT_MS, window_switch_timeout_callback, NULL);
     }
+}
 
-    return state;
+// Detent coalescing and acceleration
+//
+// Detents arriving within ENCODER_COALESCE_MS of the first are merged and
+// dispatched together as one multi-step action. Each detent also counts for
+// more steps the faster the knob turns: ENCODER_ACCEL_MS divided by the time
+// since the previous detent, from 1 up to ENCODER_ACCEL_MAX. Distance actions
+// (scroll, volume, cursor, paging) use the accelerated steps, while discrete
+// actions (switching, undo, tracks, RGB) use the detent count.
+#define ENCODER_COALESCE_MS 5
+#define ENCODER_ACCEL_MS 60
+#define ENCODER_ACCEL_MAX 4
+#define ENCODER_STEPS_MAX 16
+
+static int8_t   enc_detents[ENCODER_COUNT];
+static int8_t   enc_steps[ENCODER_COUNT];
+static uint16_t enc_detent_time[ENCODER_COUNT];
+static deferred_token enc_flush_token = INVALID_DEFERRED_TOKEN;
+
+// Tap keycode once per step
+static void encoder_tap(int8_t steps, uint16_t keycode) {
+    for (uint8_t n = steps > 0 ? steps : -steps; n > 0; n--) {
+        u_output_tap(keycode);
+    }
 }
 
-// Chordal hold layout - conditional based on revision
-#if defined(KEYBOARD_crkbd_rev4_1_standard) || defined(KEYBOARD_crkbd_rev4_1_mini)
-const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
-    LAYOUT_split_3x6_3_ex2(
-        'L', 'L', 'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L', 'L',            'R', 'R', 'R', 'R', 'R', 'R',
-                            'X', 'X', 'X',  'X', 'X', 'X'
-    );
+// Scroll by steps, up/right positive. With MIRYOKU_HIRES_SCROLL the steps go
+// straight into the mouse report as one wheel delta, otherwise they are
+// tapped as mousekey wheel keys
+static void encoder_scroll(int8_t v, int8_t h) {
+#if defined(MIRYOKU_HIRES_SCROLL)
+    u_mouse_wheel(v, h);
 #else
-const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
-    LAYOUT_split_3x6_3(
-        'L', 'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R', 'R',
-        'L', 'L', 'L', 'L', 'L', 'L',  'R', 'R', 'R', 'R', 'R', 'R',
-                       'X', 'X', 'X',  'X', 'X', 'X'
-    );
+    if (v) {
+        encoder_tap(v, v > 0 ? MS_WHLU : MS_WHLD);
+    }
+    if (h) {
+        encoder_tap(h, h > 0 ? MS_WHLR : MS_WHLL);
+    }
 #endif
+}
 
-// Handle encoder behavior when no encoder button is pressed
-static void handle_encoder_no_button(uint8_t index, bool clockwise, uint8_t current_layer) {
-    switch (current_layer) {
-        case U_BASE:
-        case U_EXTRA:
-        case U_TAP:
-            if (index == 0) { // Left encoder: App switching with platform modifier held
-                if (!enc_state.app_switching_active) {
-                    register_mods(U_APP_MOD);
-                    enc_state.app_switching_active = true;
-                }
-                if (clockwise) {
-                    tap_code(KC_TAB);
-                } else {
-                    tap_code16(LSFT(KC_TAB));
-                }
-
-                // Cancel any existing timeout and schedule a new one
-                if (window_switch_timeout_token != INVALID_DEFERRED_TOKEN) {
-                    cancel_deferred_exec(window_switch_timeout_token);
-                }
-                window_switch_timeout_token = defer_exec(WINDOW_SWITCH_TIMEOUT_MS, window_switch_timeout_callback, NULL);
-            } else if (index == 2) { // Right encoder: Vertical scroll
-                tap_code(clockwise ? MS_WHLU : MS_WHLD);
-            }
-            break;
+// Dispatch the detents merged for one encoder through the action table
+static void handle_encoder(uint8_t index, int8_t detents, int8_t steps) {
+    uint8_t current_layer = current_encoder_layer(layer_state);
+    bool    held          = current_layer == encoder_button_layers[index];
+    uint8_t context_layer = held ? enc_state.base_layer : current_layer;
 
-        case U_BUTTON:
-            if (index == 0) { // Left encoder: Browser forward/backward (media keys on Windows/Linux, CMD+[/] on Mac)
-                tap_code16(clockwise ? U_FWD : U_BCK);
-            } else if (index == 2) { // Right encoder: Undo/redo
-                tap_code16(clockwise ? U_RDO : U_UND); // Use tap_code16 for modifier combinations
-            }
-            break;
+    // Another encoder's button is held
+    if (context_layer >= ARRAY_SIZE(encoder_actions)) {
+        return;
+    }
 
-        case U_NAV:
-            if (index == 0) { // Left encoder: Left/right cursor
-                tap_code(clockwise ? KC_RGHT : KC_LEFT);
-            } else if (index == 2) { // Right encoder: Undo/redo
-                tap_code16(clockwise ? U_RDO : U_UND); // Use tap_code16 for modifier combinations
-            }
+    encoder_action_t action;
+    memcpy_P(&action, &encoder_actions[context_layer][index][held][detents > 0], sizeof(action));
+
+    switch (action.type) {
+        case ENC_TYPE_KEY:
+            encoder_tap(detents, action.arg);
             break;
 
-        case U_MOUSE:
-            if (index == 0) { // Left encoder: Horizontal scroll
-                tap_code(clockwise ? MS_WHLR : MS_WHLL);
-            } else if (index == 2) { // Right encoder: Vertical scroll
-                tap_code(clockwise ? MS_WHLU : MS_WHLD);
-            }
+        case ENC_TYPE_MOVE:
+            encoder_tap(steps, action.arg);
             break;
 
-        case U_MEDIA:
-            if (index == 0) { // Left encoder: Volume
-                tap_code(clockwise ? KC_VOLU : KC_VOLD);
-            } else if (index == 2) { // Right encoder: Volume control
-                tap_code(clockwise ? KC_VOLU : KC_VOLD);
-            }
+        case ENC_TYPE_SCROLL_V:
+            encoder_scroll(steps, 0);
             break;
 
-        case U_NUM:
-            if (index == 0) { // Left encoder: Window switching with Alt modifier held
-                if (!enc_state.window_switching_active) {
-                    register_mods(MOD_BIT(KC_LALT));
-                    enc_state.window_switching_active = true;
-                }
-                tap_code16(clockwise ? KC_TAB : LSFT(KC_TAB));
-            } else if (index == 2) { // Right encoder: Vertical scroll
-                tap_code(clockwise ? MS_WHLU : MS_WHLD);
-            }
+        case ENC_TYPE_SCROLL_H:
+            encoder_scroll(0, steps);
             break;
 
-        case U_SYM:
-            if (index == 0) { // Left encoder: Tab switching with platform modifier held
-                if (!enc_state.tab_switching_active) {
-                    register_mods(U_TAB_MOD);
-                    enc_state.tab_switching_active = true;
-                }
-                if (clockwise) {
-                    tap_code(KC_TAB);
-                } else {
-                    tap_code16(LSFT(KC_TAB)); // Use tap_code16 for modifier combinations
-                }
-            } else if (index == 2) { // Right encoder: Vertical scroll
-                tap_code(clockwise ? MS_WHLU : MS_WHLD);
+        case ENC_TYPE_SESSION:
+        case ENC_TYPE_SESSION_TIMEOUT:
+            hold_encoder_mods(action.mods, context_layer, action.type == ENC_TYPE_SESSION_TIMEOUT);
+            encoder_tap(detents, action.arg);
+            // No free executor slot means the timeout would never fire, so
+            // end the session now instead of leaving the modifier stuck
+            if (action.type == ENC_TYPE_SESSION_TIMEOUT && window_switch_timeout_token == INVALID_DEFERRED_TOKEN) {
+                release_encoder_mods();
             }
             break;
 
-        case U_FUN:
-            if (index == 0) { // Left encoder: RGB animation
-                // Use direct RGB matrix functions instead of keycodes with tap_code()
-                if (clockwise) {
-                    rgb_matrix_step();
-                } else {
-                    rgb_matrix_step_reverse();
-                }
-            } else if (index == 2) { // Right encoder: RGB brightness
-                // Use direct RGB matrix functions for immediate effect
-                if (clockwise) {
-                    rgb_matrix_increase_val();
-                } else {
-                    rgb_matrix_decrease_val();
-                }
+        case ENC_TYPE_RGB:
+            // Use direct RGB matrix functions for immediate effect
+            for (uint8_t n = detents > 0 ? detents : -detents; n > 0; n--) {
+                encoder_rgb_functions[action.arg]();
             }
             break;
     }
 }
 
-// Handle left encoder when its button is held
-static void handle_left_encoder_with_button(bool clockwise, uint8_t context_layer) {
-    switch (context_layer) {
-        case U_BASE:
-        case U_EXTRA:
-        case U_TAP:
-            // Volume control
-            tap_code(clockwise ? KC_VOLU : KC_VOLD);
-            break;
-
-        case U_NUM:
-            // Window management with platform modifier held
-            if (!enc_state.num_window_switching_active) {
-                register_mods(U_WIN_MOD);
-                enc_state.num_window_switching_active = true;
-            }
-            #if defined(MIRYOKU_CLIPBOARD_MAC)
-                // On Mac: CMD+` (grave accent) for window switching within the same app
-                tap_code16(clockwise ? KC_GRV : LSFT(KC_GRV));
-            #else
-                // On Windows/Linux: Alt+Tab for window switching
-                tap_code16(clockwise ? KC_TAB : LSFT(KC_TAB));
-            #endif
-            break;
-
-        case U_SYM:
-            // Recent tabs (browser)
-            tap_code16(clockwise ? LCTL(KC_TAB) : LCTL(LSFT(KC_TAB)));
-            break;
-
-        case U_NAV:
-            // Word-wise navigation
-            tap_code16(clockwise ? LCTL(KC_RGHT) : LCTL(KC_LEFT));
-            break;
-
-        case U_FUN:
-            // RGB animation speed
-            if (clockwise) {
-                rgb_matrix_increase_speed();
-            } else {
-                rgb_matrix_decrease_speed();
-            }
-            break;
-
-        default:
-            // Default: Volume
-            tap_code(clockwise ? KC_VOLU : KC_VOLD);
-            break;
+static void flush_encoders(void) {
+    for (uint8_t index = 0; index < ENCODER_COUNT; index++) {
+        if (enc_detents[index] != 0) {
+            handle_encoder(index, enc_detents[index], enc_steps[index]);
+            enc_detents[index] = 0;
+            enc_steps[index]   = 0;
+        }
     }
 }
 
-// Handle right encoder when its button is held
-static void handle_right_encoder_with_button(bool clockwise, uint8_t context_layer) {
-    switch (context_layer) {
-        case U_BASE:
-        case U_EXTRA:
-        case U_TAP:
-            // Page navigation
-            tap_code(clockwise ? KC_PGDN : KC_PGUP);
-            break;
-
-        case U_MOUSE:
-            // Mouse wheel horizontal
-            tap_code(clockwise ? MS_WHLR : MS_WHLL);
-            break;
-
-        case U_MEDIA:
-            // Track prev/next
-            tap_code(clockwise ? KC_MNXT : KC_MPRV);
-            break;
-
-        case U_FUN:
-            // RGB hue
-            if (clockwise) {
-                rgb_matrix_increase_hue();
-            } else {
-                rgb_matrix_decrease_hue();
-            }
-            break;
-
-        default:
-            // Default: Vertical scroll
-            tap_code(clockwise ? MS_WHLU : MS_WHLD);
-            break;
-    }
+static uint32_t encoder_flush_callback(uint32_t trigger_time, void *cb_arg) {
+    enc_flush_token = INVALID_DEFERRED_TOKEN;
+    flush_encoders();
+    return 0; // Don't repeat
 }
 
 bool encoder_update_user(uint8_t index, bool clockwise) {
-    uint8_t current_layer = get_highest_layer(layer_state);
-
-    // Left encoder (index 0)
-    if (index == 0) {
-        if (current_layer == U_ENC_LEFT) {
-            // Left encoder button is held - use special behavior
-            handle_left_encoder_with_button(clockwise, enc_state.base_layer);
-        } else {
-            // No button held - use normal layer behavior
-            handle_encoder_no_button(index, clockwise, current_layer);
-        }
+    if (index >= ENCODER_COUNT) {
+        return false;
+    }
+
+    uint16_t interval = timer_elapsed(enc_detent_time[index]);
+    int8_t   accel    = MIN(ENCODER_ACCEL_MAX, MAX(1, ENCODER_ACCEL_MS / MAX(interval, 1)));
+    enc_detent_time[index] = timer_read();
+
+    // A reversal drops what was merged in the old direction
+    if ((enc_detents[index] > 0) != clockwise) {
+        enc_detents[index] = 0;
+        enc_steps[index]   = 0;
     }
-    // Right encoder (index 2)
-    else if (index == 2) {
-        if (current_layer == U_ENC_RIGHT) {
-            // Right encoder button is held - use special behavior
-            handle_right_encoder_with_button(clockwise, enc_state.base_layer);
-        } else {
-            // No button held - use normal layer behavior
-            handle_encoder_no_button(index, clockwise, current_layer);
+    enc_detents[index] += clockwise ? 1 : -1;
+    enc_steps[index] = clockwise ? MIN(enc_steps[index] + accel, ENCODER_STEPS_MAX) : MAX(enc_steps[index] - accel, -ENCODER_STEPS_MAX);
+
+    if (enc_flush_token == INVALID_DEFERRED_TOKEN) {
+        enc_flush_token = defer_exec(ENCODER_COALESCE_MS, encoder_flush_callback, NULL);
+        // No free executor slot, so dispatch now rather than lose the detents
+        if (enc_flush_token == INVALID_DEFERRED_TOKEN) {
+            flush_encoders();
         }
     }
 
@@ -36,24 +36,34 @@ void suspend_wakeup_init_user(void) {
     adns5050_init();
 }
 
+// A timer_read() value of 0 is a valid timestamp once the 16-bit timer wraps,
+// so activity is tracked with flags rather than by zeroing the timers
+static bool     moving     = false;
 static uint16_t idle_timer = 0;
 #ifdef TAP_MODE
-static uint16_t drag_timer = 0;
+static bool     drag_pending = false;
+static uint16_t drag_timer   = 0;
+static bool     key_tapped   = false;
 #endif
 
 report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
     // if there's movement
     if (mouse_report.x != 0 || mouse_report.y != 0) {
-        // if the idle timer is not set, send the key event or start drag timer
-        if (!idle_timer) {
+        // on the first movement, send the key event or start drag timer
+        if (!moving) {
 #ifdef TAP_MODE
-            // In tap mode, tap the key immediately and start the drag delay timer
-            tap_code(KEY_CODE);
-            drag_timer = timer_read();
+            // In tap mode, press the key immediately and start the drag delay timer.
+            // The key is released on the next housekeeping pass rather than after
+            // a blocking TAP_CODE_DELAY, so sensor polling is never stalled
+            register_code(KEY_CODE);
+            key_tapped   = true;
+            drag_timer   = timer_read();
+            drag_pending = true;
 #else
             // In hold mode, register (hold) the key
             register_code(KEY_CODE);
 #endif
+            moving = true;
         }
         // update the timer
         idle_timer = timer_read();
@@ -63,15 +73,21 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
 
 void housekeeping_task_user(void) {
 #ifdef TAP_MODE
+    // Release the tapped key, one pass after its press was reported
+    if (key_tapped) {
+        unregister_code(KEY_CODE);
+        key_tapped = false;
+    }
+
     // In tap mode, start drag after delay if not already started
-    if (drag_timer && timer_elapsed(drag_timer) >= DRAG_DELAY) {
+    if (drag_pending && timer_elapsed(drag_timer) >= DRAG_DELAY) {
         register_code(KC_BTN1);
-        drag_timer = 0;  // Clear timer to prevent repeated button presses
+        drag_pending = false;  // Prevent repeated button presses
     }
 #endif
 
-    // if the idle timer is set and the timer has expired, handle key release and reset the timer
-    if (idle_timer && timer_elapsed(idle_timer) >= IDLE_TIMEOUT) {
+    // if movement is active and the idle timer has expired, handle key release
+    if (moving && timer_elapsed(idle_timer) >= IDLE_TIMEOUT) {
 #ifdef TAP_MODE
         // In tap mode, always end the mouse drag (drag must be active due to DRAG_DELAY < IDLE_TIMEOUT assertion)
         unregister_code(KC_BTN1);
@@ -79,6 +95,6 @@ void housekeeping_task_user(void) {
         // In hold mode, unregister (release) the key after idle timeout
         unregister_code(KEY_CODE);
 #endif
-        idle_timer = 0;
+        moving = false;
     }
 }
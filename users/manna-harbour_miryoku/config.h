@@ -17,6 +17,7 @@
 #define NO_AUTO_SHIFT_ALPHA
 #define AUTO_SHIFT_TIMEOUT TAPPING_TERM
 #define AUTO_SHIFT_NO_SETUP
+#define AUTO_SHIFT_TIMEOUT_PER_KEY
 
 // Mouse key speed and acceleration.
 #undef MOUSEKEY_DELAY
@@ -34,6 +35,69 @@
 #if defined (MIRYOKU_KLUDGE_THUMBCOMBOS)
   #define COMBO_TERM 200
   #define EXTRA_SHORT_COMBOS
+  #define COMBO_ONLY_FROM_LAYER 0
+  #define COMBO_SHOULD_TRIGGER
+  #define COMBO_TERM_PER_COMBO
+  #if !defined (MIRYOKU_THUMBCOMBO_TERM)
+    #define MIRYOKU_THUMBCOMBO_TERM 50
+  #endif
 #endif
 
 #include "custom_config.h"
+
+// Cross-hand hold, opt-in per tap-hold kind
+#if defined (MIRYOKU_INSTANT_HOLD) || defined (MIRYOKU_EARLY_LAYER)
+  #define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+#endif
+
+// High resolution wheel scrolling, as a fraction of a detent per step
+#if defined (MIRYOKU_HIRES_SCROLL)
+  #define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+  #define WHEEL_EXTENDED_REPORT
+  #if !defined (POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER)
+    #define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+  #endif
+  #if !defined (MIRYOKU_HIRES_SCROLL_DIVISOR)
+    #define MIRYOKU_HIRES_SCROLL_DIVISOR 2
+  #endif
+#endif
+
+// Tap-hold telemetry, one slot per tap-hold keycode
+#if defined (MIRYOKU_TELEMETRY)
+  #if !defined (MIRYOKU_TELEMETRY_KEYS)
+    #if defined (__AVR__)
+      #define MIRYOKU_TELEMETRY_KEYS 8
+    #else
+      #define MIRYOKU_TELEMETRY_KEYS 18
+    #endif
+  #endif
+  // permissive holds are recorded from get_permissive_hold()
+  #if defined (PERMISSIVE_HOLD)
+    #define PERMISSIVE_HOLD_PER_KEY
+  #endif
+#endif
+
+// EEPROM user datablock, shared by the options that persist state
+#if defined (MIRYOKU_TELEMETRY_EEPROM)
+  #define U_EEPROM_TELEMETRY_SIZE (MIRYOKU_TELEMETRY_KEYS * 16)
+#else
+  #define U_EEPROM_TELEMETRY_SIZE 0
+#endif
+#if defined (MIRYOKU_TAPPING_TERM_ADAPTIVE)
+  #define U_EEPROM_TAPPING_TERM_SIZE (40 * 3)
+#else
+  #define U_EEPROM_TAPPING_TERM_SIZE 0
+#endif
+// versioned by a header, see miryoku_eeprom.h
+#if U_EEPROM_TELEMETRY_SIZE + U_EEPROM_TAPPING_TERM_SIZE > 0
+  #define U_EEPROM_HEADER_SIZE 6
+#else
+  #define U_EEPROM_HEADER_SIZE 0
+#endif
+#define U_EEPROM_HEADER_OFFSET 0
+#define U_EEPROM_TELEMETRY_OFFSET (U_EEPROM_HEADER_OFFSET + U_EEPROM_HEADER_SIZE)
+#define U_EEPROM_TAPPING_TERM_OFFSET (U_EEPROM_TELEMETRY_OFFSET + U_EEPROM_TELEMETRY_SIZE)
+#define U_EEPROM_SIZE (U_EEPROM_TAPPING_TERM_OFFSET + U_EEPROM_TAPPING_TERM_SIZE)
+#if U_EEPROM_SIZE > 0
+  #define EECONFIG_USER_DATA_SIZE U_EEPROM_SIZE
+#endif
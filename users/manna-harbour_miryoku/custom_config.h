@@ -12,6 +12,7 @@
 #define TAPPING_TERM 250
 #undef QUICK_TAP_TERM
 #define QUICK_TAP_TERM 120
+#define QUICK_TAP_TERM_PER_KEY
 #define TAPPING_TERM_PER_KEY
 #define PERMISSIVE_HOLD
 #define CHORDAL_HOLD
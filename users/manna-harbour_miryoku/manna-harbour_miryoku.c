@@ -7,9 +7,37 @@
 
 #include "manna-harbour_miryoku.h"
 
+#include "miryoku_tapping_term.h"
+#include "miryoku_roll.h"
+#include "miryoku_burst.h"
+#include "miryoku_autoshift.h"
+#include "miryoku_output.h"
+#include "miryoku_mouse.h"
+#include "miryoku_eeprom.h"
+#if defined (RAW_ENABLE)
+  #include "raw_hid.h"
+#endif
+#if defined (MIRYOKU_TIMER)
+  #include "miryoku_timer.h"
+#endif
+#if defined (MIRYOKU_RECORDER)
+  #include "miryoku_recorder.h"
+#endif
+#if defined (MIRYOKU_PROFILER)
+  #include "miryoku_profiler.h"
+#endif
+#if defined (MIRYOKU_TELEMETRY)
+  #include "miryoku_telemetry.h"
+#endif
+
 
 // Additional Features double tap guard
 
+// The guard keys keep their TD() keycodes in the layer tables but are handled
+// here instead of by tap dance. A second tap of the same guard key within
+// TAPPING_TERM runs its action. Other keys are never held back, and any other
+// press cancels the first tap.
+
 enum {
     U_TD_BOOT,
 #define MIRYOKU_X(LAYER, STRING) U_TD_U_##LAYER,
@@ -17,27 +45,45 @@ MIRYOKU_LAYER_LIST
 #undef MIRYOKU_X
 };
 
-void u_td_fn_boot(tap_dance_state_t *state, void *user_data) {
-  if (state->count == 2) {
-    reset_keyboard();
-  }
-}
+#define U_TD_PENDING 0x80 // first tap seen, guard index in the low bits
 
+static uint8_t u_td_state;
+static uint16_t u_td_time;
+
+static void u_td_fire(uint8_t index) {
+  switch (index) {
+    case U_TD_BOOT:
+      reset_keyboard();
+      break;
 #define MIRYOKU_X(LAYER, STRING) \
-void u_td_fn_U_##LAYER(tap_dance_state_t *state, void *user_data) { \
-  if (state->count == 2) { \
-    default_layer_set((layer_state_t)1 << U_##LAYER); \
-  } \
-}
+    case U_TD_U_##LAYER: \
+      default_layer_set((layer_state_t)1 << U_##LAYER); \
+      break;
 MIRYOKU_LAYER_LIST
 #undef MIRYOKU_X
+  }
+}
 
-tap_dance_action_t tap_dance_actions[] = {
-    [U_TD_BOOT] = ACTION_TAP_DANCE_FN(u_td_fn_boot),
-#define MIRYOKU_X(LAYER, STRING) [U_TD_U_##LAYER] = ACTION_TAP_DANCE_FN(u_td_fn_U_##LAYER),
-MIRYOKU_LAYER_LIST
-#undef MIRYOKU_X
-};
+// Returns false for guard keys, which send nothing
+static bool u_td_process(uint16_t keycode, keyrecord_t *record) {
+  if (!IS_QK_TAP_DANCE(keycode)) {
+    if (record->event.pressed) {
+      u_td_state = 0;
+    }
+    return true;
+  }
+  if (record->event.pressed) {
+    uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+    if (u_td_state == (U_TD_PENDING | index) && timer_elapsed(u_td_time) < TAPPING_TERM) {
+      u_td_state = 0;
+      u_td_fire(index);
+    } else {
+      u_td_state = U_TD_PENDING | index;
+      u_td_time = record->event.time;
+    }
+  }
+  return false;
+}
 
 
 // keymap
@@ -49,6 +95,30 @@ MIRYOKU_LAYER_LIST
 };
 
 
+// key positions
+
+#define U_KEY_INDEX_MARK(index) (0xFF00 | (index))
+
+static const uint16_t PROGMEM u_key_index_map[MATRIX_ROWS][MATRIX_COLS] = U_MACRO_VA_ARGS(MIRYOKU_LAYERMAPPING_BASE,
+  U_KEY_INDEX_MARK(0),  U_KEY_INDEX_MARK(1),  U_KEY_INDEX_MARK(2),  U_KEY_INDEX_MARK(3),  U_KEY_INDEX_MARK(4),
+  U_KEY_INDEX_MARK(5),  U_KEY_INDEX_MARK(6),  U_KEY_INDEX_MARK(7),  U_KEY_INDEX_MARK(8),  U_KEY_INDEX_MARK(9),
+  U_KEY_INDEX_MARK(10), U_KEY_INDEX_MARK(11), U_KEY_INDEX_MARK(12), U_KEY_INDEX_MARK(13), U_KEY_INDEX_MARK(14),
+  U_KEY_INDEX_MARK(15), U_KEY_INDEX_MARK(16), U_KEY_INDEX_MARK(17), U_KEY_INDEX_MARK(18), U_KEY_INDEX_MARK(19),
+  U_KEY_INDEX_MARK(20), U_KEY_INDEX_MARK(21), U_KEY_INDEX_MARK(22), U_KEY_INDEX_MARK(23), U_KEY_INDEX_MARK(24),
+  U_KEY_INDEX_MARK(25), U_KEY_INDEX_MARK(26), U_KEY_INDEX_MARK(27), U_KEY_INDEX_MARK(28), U_KEY_INDEX_MARK(29),
+  U_KEY_INDEX_MARK(30), U_KEY_INDEX_MARK(31), U_KEY_INDEX_MARK(32), U_KEY_INDEX_MARK(33), U_KEY_INDEX_MARK(34),
+  U_KEY_INDEX_MARK(35), U_KEY_INDEX_MARK(36), U_KEY_INDEX_MARK(37), U_KEY_INDEX_MARK(38), U_KEY_INDEX_MARK(39)
+);
+
+uint8_t u_key_index(keypos_t key) {
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return U_KEY_INDEX_NONE;
+  }
+  uint16_t mark = pgm_read_word(&u_key_index_map[key.row][key.col]);
+  return (mark & 0xFF00) == 0xFF00 ? mark & 0xFF : U_KEY_INDEX_NONE;
+}
+
+
 // shift functions
 
 const key_override_t capsword_key_override = ko_make_basic(MOD_MASK_SHIFT, CW_TOGG, KC_CAPS);
@@ -61,99 +131,540 @@ const key_override_t *key_overrides[] = (const key_override_t *[]){
 // thumb combos
 
 #if defined (MIRYOKU_KLUDGE_THUMBCOMBOS)
-const uint16_t PROGMEM thumbcombos_base_right[] = {LT(U_SYM, KC_ENT), LT(U_NUM, KC_BSPC), COMBO_END};
-const uint16_t PROGMEM thumbcombos_base_left[] = {LT(U_NAV, KC_SPC), LT(U_MOUSE, KC_TAB), COMBO_END};
-const uint16_t PROGMEM thumbcombos_nav[] = {KC_ENT, KC_BSPC, COMBO_END};
-const uint16_t PROGMEM thumbcombos_mouse[] = {KC_BTN2, KC_BTN1, COMBO_END};
-const uint16_t PROGMEM thumbcombos_media[] = {KC_MSTP, KC_MPLY, COMBO_END};
-const uint16_t PROGMEM thumbcombos_num[] = {KC_0, KC_MINS, COMBO_END};
-  #if defined (MIRYOKU_LAYERS_FLIP)
-const uint16_t PROGMEM thumbcombos_sym[] = {KC_UNDS, KC_LPRN, COMBO_END};
-  #else
-const uint16_t PROGMEM thumbcombos_sym[] = {KC_RPRN, KC_UNDS, COMBO_END};
-  #endif
-const uint16_t PROGMEM thumbcombos_fun[] = {KC_SPC, KC_TAB, COMBO_END};
+// Combos are matched by position on the base layer (COMBO_ONLY_FROM_LAYER), so
+// each hand's primary and secondary thumb keys form one key set. Every layer
+// gets a combo per hand that sends that layer's tertiary thumb key. Only the
+// active layer's pair is enabled, and off the base layer only the hand opposite
+// the thumb holding the layer, as with the original per-layer combos, so thumb
+// keys are not held back on layers where the tertiary key is unused.
+#define U_THUMBCOMBO_KEYS_LEFT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K33, K34
+#define U_THUMBCOMBO_KEYS_RIGHT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K35, K36
+#define U_THUMBCOMBO_OUTPUT_LEFT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K32
+#define U_THUMBCOMBO_OUTPUT_RIGHT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K37
+#define U_THUMBCOMBO_THUMBS_LEFT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K32, K33, K34
+#define U_THUMBCOMBO_THUMBS_RIGHT(K00, K01, K02, K03, K04, K05, K06, K07, K08, K09, K10, K11, K12, K13, K14, K15, K16, K17, K18, K19, K20, K21, K22, K23, K24, K25, K26, K27, K28, K29, K30, K31, K32, K33, K34, K35, K36, K37, K38, K39) K35, K36, K37
+
+const uint16_t PROGMEM thumbcombos_left[] = {U_MACRO_VA_ARGS(U_THUMBCOMBO_KEYS_LEFT, MIRYOKU_LAYER_BASE), COMBO_END};
+const uint16_t PROGMEM thumbcombos_right[] = {U_MACRO_VA_ARGS(U_THUMBCOMBO_KEYS_RIGHT, MIRYOKU_LAYER_BASE), COMBO_END};
+static const uint16_t PROGMEM thumbcombos_thumbs_left[] = {U_MACRO_VA_ARGS(U_THUMBCOMBO_THUMBS_LEFT, MIRYOKU_LAYER_BASE)};
+static const uint16_t PROGMEM thumbcombos_thumbs_right[] = {U_MACRO_VA_ARGS(U_THUMBCOMBO_THUMBS_RIGHT, MIRYOKU_LAYER_BASE)};
+
 combo_t key_combos[] = {
-  COMBO(thumbcombos_base_right, LT(U_FUN, KC_DEL)),
-  COMBO(thumbcombos_base_left, LT(U_MEDIA, KC_ESC)),
-  COMBO(thumbcombos_nav, KC_DEL),
-  COMBO(thumbcombos_mouse, KC_BTN3),
-  COMBO(thumbcombos_media, KC_MUTE),
-  COMBO(thumbcombos_num, KC_DOT),
-  #if defined (MIRYOKU_LAYERS_FLIP)
-  COMBO(thumbcombos_sym, KC_RPRN),
-  #else
-  COMBO(thumbcombos_sym, KC_LPRN),
-  #endif
-  COMBO(thumbcombos_fun, KC_APP)
+#define MIRYOKU_X(LAYER, STRING) \
+  [U_##LAYER * 2] = COMBO(thumbcombos_left, U_MACRO_VA_ARGS(U_THUMBCOMBO_OUTPUT_LEFT, MIRYOKU_LAYER_##LAYER)), \
+  [U_##LAYER * 2 + 1] = COMBO(thumbcombos_right, U_MACRO_VA_ARGS(U_THUMBCOMBO_OUTPUT_RIGHT, MIRYOKU_LAYER_##LAYER)),
+MIRYOKU_LAYER_LIST
+#undef MIRYOKU_X
 };
+
+static bool thumbcombos_held_from(uint8_t layer, const uint16_t *thumbs) {
+  for (uint8_t i = 0; i < 3; i++) {
+    uint16_t keycode = pgm_read_word(&thumbs[i]);
+    if (IS_QK_LAYER_TAP(keycode) && QK_LAYER_TAP_GET_LAYER(keycode) == layer) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record) {
+  uint8_t layer = combo_index / 2;
+  if (layer != get_highest_layer(layer_state | default_layer_state) || combo->keycode == KC_NO) {
+    return false;
+  }
+  if (layer == get_highest_layer(default_layer_state)) {
+    return true;
+  }
+  // the right pair is used while a left thumb holds the layer, and vice versa
+  return thumbcombos_held_from(layer, combo_index % 2 ? thumbcombos_thumbs_left : thumbcombos_thumbs_right);
+}
+
+uint16_t get_combo_term(uint16_t combo_index, combo_t *combo) {
+  return MIRYOKU_THUMBCOMBO_TERM;
+}
 #endif
 
-// Leader as shift for alpha
-bool leader_add_user(uint16_t keycode) {
+// tap-hold
+
+#if defined (TAPPING_TERM_PER_KEY)
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return u_tapping_term(keycode, record);
+}
+#endif
+
+#if defined (FLOW_TAP_TERM)
+uint16_t get_flow_tap_term(uint16_t keycode, keyrecord_t *record, uint16_t prev_keycode) {
+    if (is_flow_tap_key(keycode) && is_flow_tap_key(prev_keycode)) {
+        return u_burst_flow_tap_term();
+    }
+    return 0;
+}
+#endif
+
+#if defined (QUICK_TAP_TERM_PER_KEY)
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    return MIN(u_burst_quick_tap_term(), GET_TAPPING_TERM(keycode, record));
+}
+#endif
+
+#if defined (CHORDAL_HOLD)
+// generated from MIRYOKU_MAPPING, so no chordal_hold_layout per keyboard;
+// thumbs are exempt so thumb layer-taps can chord with either hand
+char chordal_hold_handedness(keypos_t key) {
+    uint8_t index = u_key_index(key);
+    return index == U_KEY_INDEX_NONE || U_KEY_INDEX_IS_THUMB(index) ? '*' : U_KEY_INDEX_HAND(index);
+}
+
+bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record) {
+    // settle frequent rolls as taps on the second press, whichever hands
+    bool hold = !u_roll(tap_hold_keycode, tap_hold_record, other_keycode, other_record) && get_chordal_hold_default(tap_hold_record, other_record);
+    if (!hold) {
+        u_tapping_term_settled(tap_hold_record);
+#if defined (MIRYOKU_TELEMETRY)
+        u_telemetry_decision(tap_hold_record, U_TELEMETRY_CHORDAL);
+#endif
+    }
+    return hold;
+}
+#endif
+
+#if defined (PERMISSIVE_HOLD_PER_KEY)
+bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
+#if defined (MIRYOKU_TELEMETRY)
+    u_telemetry_decision(record, U_TELEMETRY_PERMISSIVE);
+#endif
+    return true;
+}
+#endif
+
+// Cross-hand hold: a tap-hold key is settled as held by the press of a key on
+// the other hand once it has been down for a minimum time. With
+// MIRYOKU_INSTANT_HOLD home row mod-taps commit the mod, with
+// MIRYOKU_EARLY_LAYER thumb layer-taps
+// commit to the layer so the next key is resolved there straight away; the
+// layer is not taken back if the thumb key turns out to be a tap. The minimum
+// keeps typing rolls, including frequent bigrams, on the tap path.
+#if defined (HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+  #if defined (MIRYOKU_EARLY_LAYER) && !defined (MIRYOKU_EARLY_LAYER_TERM)
+    #define MIRYOKU_EARLY_LAYER_TERM 80
+  #endif
+  #if defined (MIRYOKU_INSTANT_HOLD) && !defined (MIRYOKU_INSTANT_HOLD_TERM)
+    #define MIRYOKU_INSTANT_HOLD_TERM MIRYOKU_ROLL_TERM
+  #endif
+
+// Each tap-hold key down and the first key pressed after it, which is the one
+// that decides it even when QMK replays buffered presses later
+#define U_CROSS_HAND_SLOTS 4
+
+typedef struct {
+    bool active;
+    bool interrupted;
+    keypos_t key;
+    keypos_t other;
+    uint16_t time;
+} u_cross_hand_t;
+
+static u_cross_hand_t u_cross_hand[U_CROSS_HAND_SLOTS];
+static uint8_t u_cross_hand_next;
+
+static void u_cross_hand_pre_process(uint16_t keycode, keyrecord_t *record) {
+    for (uint8_t i = 0; i < U_CROSS_HAND_SLOTS; i++) {
+        u_cross_hand_t *slot = &u_cross_hand[i];
+        if (!slot->active) {
+            continue;
+        }
+        if (KEYEQ(slot->key, record->event.key)) {
+            slot->active = false;
+        } else if (record->event.pressed && !slot->interrupted) {
+            slot->interrupted = true;
+            slot->other = record->event.key;
+            slot->time = record->event.time;
+        }
+    }
+    if (record->event.pressed && (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode))) {
+        u_cross_hand[u_cross_hand_next] = (u_cross_hand_t){.active = true, .key = record->event.key};
+        u_cross_hand_next = (u_cross_hand_next + 1) % U_CROSS_HAND_SLOTS;
+    }
+}
+
+#if defined (MIRYOKU_EARLY_LAYER)
+// Letters on the target layer, or let through from the base layer, are left
+// to the tapping term, as an early layer would only change what is typed
+static bool u_cross_hand_alpha(uint8_t layer, keypos_t key) {
+    uint16_t keycode = keymap_key_to_keycode(layer, key);
+    if (keycode == KC_TRNS) {
+        keycode = keymap_key_to_keycode(get_highest_layer(default_layer_state), key);
+    }
+    if (IS_QK_MOD_TAP(keycode)) {
+        keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    } else if (IS_QK_LAYER_TAP(keycode)) {
+        keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    return keycode >= KC_A && keycode <= KC_Z;
+}
+#endif
+
+bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
+    const u_cross_hand_t *slot = NULL;
+    for (uint8_t i = 0; i < U_CROSS_HAND_SLOTS; i++) {
+        if (u_cross_hand[i].active && KEYEQ(u_cross_hand[i].key, record->event.key)) {
+            slot = &u_cross_hand[i];
+        }
+    }
+    if (!slot || !slot->interrupted) {
+        return false;
+    }
+    uint8_t index = u_key_index(record->event.key);
+    uint8_t other = u_key_index(slot->other);
+    if (index == U_KEY_INDEX_NONE || other == U_KEY_INDEX_NONE || U_KEY_INDEX_HAND(other) == U_KEY_INDEX_HAND(index)) {
+        return false;
+    }
+    uint16_t elapsed = TIMER_DIFF_16(slot->time, record->event.time);
+    bool hold = false;
+    if (U_KEY_INDEX_IS_THUMB(index)) {
+#if defined (MIRYOKU_EARLY_LAYER)
+        hold = IS_QK_LAYER_TAP(keycode) && elapsed >= MIRYOKU_EARLY_LAYER_TERM && !u_cross_hand_alpha(QK_LAYER_TAP_GET_LAYER(keycode), slot->other);
+#endif
+    } else {
+#if defined (MIRYOKU_INSTANT_HOLD)
+        hold = IS_QK_MOD_TAP(keycode) && elapsed >= MIRYOKU_INSTANT_HOLD_TERM;
+#endif
+    }
+#if defined (MIRYOKU_TELEMETRY)
+    if (hold) {
+        u_telemetry_decision(record, U_TELEMETRY_CROSS_HAND);
+    }
+#endif
+    return hold;
+}
+#endif
+
+// auto shift
+
+#if defined (AUTO_SHIFT_TIMEOUT_PER_KEY)
+uint16_t get_autoshift_timeout(uint16_t keycode, keyrecord_t *record) {
+    return u_autoshift_timeout(keycode, record);
+}
+#endif
+
+
+// raw mode
+
+// Selecting the TAP base layer, which has no tap-hold keys, also turns off the
+// features that hold back key output: auto shift, combos, key overrides and
+// caps word. Pressing the two inner thumb keys together returns to the
+// previous base layer and restores them. Those keys exist on every mapping,
+// 3x5+2 included, and the chord does not rely on combos. The first press is
+// held back for MIRYOKU_RAW_EXIT_TERM in case the other follows, and both
+// presses of the chord and their releases are swallowed.
+#if !defined (MIRYOKU_RAW_EXIT_TERM)
+  #define MIRYOKU_RAW_EXIT_TERM 50
+#endif
+
+static bool u_raw_mode;
+static uint8_t u_raw_mode_return;
+static bool u_raw_mode_held;
+static bool u_raw_mode_replaying;
+static keyevent_t u_raw_mode_held_event;
+static uint8_t u_raw_mode_swallow; // chord keys whose release is swallowed
+static struct {
+    bool autoshift : 1;
+    bool combo : 1;
+    bool key_override : 1;
+} u_raw_mode_saved;
+
+static void u_raw_mode_enter(void) {
+    u_raw_mode_return = get_highest_layer(default_layer_state);
+    u_raw_mode_held = false;
+#if defined (AUTO_SHIFT_ENABLE)
+    u_raw_mode_saved.autoshift = get_autoshift_state();
+    autoshift_disable();
+#endif
+#if defined (COMBO_ENABLE)
+    u_raw_mode_saved.combo = is_combo_enabled();
+    combo_disable();
+#endif
+#if defined (KEY_OVERRIDE_ENABLE)
+    u_raw_mode_saved.key_override = key_override_is_enabled();
+    key_override_off();
+#endif
+#if defined (CAPS_WORD_ENABLE)
+    caps_word_off();
+#endif
+}
+
+static void u_raw_mode_exit(void) {
+#if defined (AUTO_SHIFT_ENABLE)
+    if (u_raw_mode_saved.autoshift) {
+        autoshift_enable();
+    }
+#endif
+#if defined (COMBO_ENABLE)
+    if (u_raw_mode_saved.combo) {
+        combo_enable();
+    }
+#endif
+#if defined (KEY_OVERRIDE_ENABLE)
+    if (u_raw_mode_saved.key_override) {
+        key_override_on();
+    }
+#endif
+}
+
+layer_state_t default_layer_state_set_user(layer_state_t state) {
+    bool raw_mode = get_highest_layer(state) == U_TAP;
+    if (raw_mode && !u_raw_mode) {
+        u_raw_mode_enter();
+    } else if (!raw_mode && u_raw_mode) {
+        u_raw_mode_exit();
+    }
+    u_raw_mode = raw_mode;
+    return state;
+}
+
+static uint8_t u_raw_mode_chord(keypos_t key) {
+    uint8_t index = u_key_index(key);
+    return index == 34 ? 1 : index == 35 ? 2 : 0;
+}
+
+// Sends the held back chord press as a key press after all
+static void u_raw_mode_release_held(void) {
+    if (u_raw_mode_held) {
+        u_raw_mode_held = false;
+        u_raw_mode_replaying = true;
+        action_exec(u_raw_mode_held_event);
+        u_raw_mode_replaying = false;
+    }
+}
+
+// Returns false for the exit chord's presses and releases, which are swallowed
+static bool u_raw_mode_pre_process(keyrecord_t *record) {
+    uint8_t chord = u_raw_mode_chord(record->event.key);
+    if (!record->event.pressed && (u_raw_mode_swallow & chord)) {
+        u_raw_mode_swallow &= ~chord;
+        return false;
+    }
+    if (!u_raw_mode || u_raw_mode_replaying) {
+        return true;
+    }
+    if (record->event.pressed && chord) {
+        if (!u_raw_mode_held) {
+            u_raw_mode_held = true;
+            u_raw_mode_held_event = record->event;
+            return false;
+        }
+        if (chord != u_raw_mode_chord(u_raw_mode_held_event.key) && TIMER_DIFF_16(record->event.time, u_raw_mode_held_event.time) < MIRYOKU_RAW_EXIT_TERM) {
+            u_raw_mode_held = false;
+            u_raw_mode_swallow = 3;
+            default_layer_set((layer_state_t)1 << u_raw_mode_return);
+            return false;
+        }
+    }
+    // anything else, including the held key's own release, lets it through first
+    u_raw_mode_release_held();
+    return true;
+}
+
+static void u_raw_mode_task(void) {
+    if (u_raw_mode_held && timer_elapsed(u_raw_mode_held_event.time) >= MIRYOKU_RAW_EXIT_TERM) {
+        u_raw_mode_release_held();
+    }
+}
+
+
+// instrumentation
+
+#if defined (RAW_ENABLE)
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+  #if defined (MIRYOKU_RECORDER)
+        case U_HID_RECORDER:
+            u_recorder_raw_hid(data, length);
+            break;
+  #endif
+  #if defined (MIRYOKU_PROFILER)
+        case U_HID_PROFILER:
+            u_profiler_raw_hid(data, length);
+            break;
+  #endif
+  #if defined (MIRYOKU_TELEMETRY)
+        case U_HID_TELEMETRY:
+            u_telemetry_raw_hid(data, length);
+            break;
+  #endif
+        default:
+            data[0] = U_HID_UNHANDLED;
+            break;
+    }
+    raw_hid_send(data, length);
+}
+#endif
+
+
+// hooks
+
+void keyboard_post_init_user(void) {
+    u_eeprom_init();
+    u_tapping_term_init();
+#if defined (MIRYOKU_TIMER)
+    u_timer_init();
+#endif
+#if defined (MIRYOKU_TELEMETRY)
+    u_telemetry_init();
+#endif
+}
+
+void housekeeping_task_user(void) {
+    u_tapping_term_task();
+    u_autoshift_eager_task();
+    u_output_task();
+    u_mouse_task();
+    u_raw_mode_task();
+#if defined (MIRYOKU_TIMER)
+    u_timer_task();
+#endif
+#if defined (MIRYOKU_TELEMETRY)
+    u_telemetry_task();
+#endif
+}
+
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (!u_output_pre_process(record)) {
+        return false;
+    }
+    if (!u_raw_mode_pre_process(record)) {
+        return false;
+    }
+    u_burst_pre_process(record);
+#if defined (HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+    u_cross_hand_pre_process(keycode, record);
+#endif
+#if defined (MIRYOKU_TELEMETRY)
+    u_telemetry_pre_process(keycode, record);
+#endif
     return true;
 }
 
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    u_tapping_term_record(keycode, record);
+#if defined (MIRYOKU_RECORDER)
+    u_recorder_record(keycode, record);
+#endif
+#if defined (MIRYOKU_TELEMETRY)
+    u_telemetry_record(keycode, record);
+#endif
+    if (!u_td_process(keycode, record)) {
+        return false;
+    }
+    if (!u_mouse_process(keycode, record)) {
+        return false;
+    }
+    return u_autoshift_eager_process(keycode, record);
+}
+
+// leader
+
+// Sequences are searched by prefix as they are typed, and end as soon as the
+// typed keys cannot be extended to a longer sequence, without waiting for the
+// leader timeout. A sequence that is also the prefix of another waits.
+
+#define U_LEADER_SEQUENCE_MAX 3
+
+typedef struct {
+    uint16_t keys[U_LEADER_SEQUENCE_MAX]; // KC_NO terminated if shorter
+    uint16_t keycode;
+    const char *string; // sent instead of keycode if set
+} u_leader_sequence_t;
+
+#define U_LEADER_KEYCODE(KEYCODE, ...) {{__VA_ARGS__}, KEYCODE, NULL},
+#define U_LEADER_STRING(STRING, ...) {{__VA_ARGS__}, KC_NO, STRING},
+
+static const u_leader_sequence_t PROGMEM u_leader_sequences[] = {
+    // Leader as shift for alpha
+    U_LEADER_KEYCODE(S(KC_A), KC_A)
+    U_LEADER_KEYCODE(S(KC_B), KC_B)
+    U_LEADER_KEYCODE(S(KC_C), KC_C)
+    U_LEADER_KEYCODE(S(KC_D), KC_D)
+    U_LEADER_KEYCODE(S(KC_E), KC_E)
+    U_LEADER_KEYCODE(S(KC_F), KC_F)
+    U_LEADER_KEYCODE(S(KC_G), KC_G)
+    U_LEADER_KEYCODE(S(KC_H), KC_H)
+    U_LEADER_KEYCODE(S(KC_I), KC_I)
+    U_LEADER_KEYCODE(S(KC_J), KC_J)
+    U_LEADER_KEYCODE(S(KC_K), KC_K)
+    U_LEADER_KEYCODE(S(KC_L), KC_L)
+    U_LEADER_KEYCODE(S(KC_M), KC_M)
+    U_LEADER_KEYCODE(S(KC_N), KC_N)
+    U_LEADER_KEYCODE(S(KC_O), KC_O)
+    U_LEADER_KEYCODE(S(KC_P), KC_P)
+    U_LEADER_KEYCODE(S(KC_Q), KC_Q)
+    U_LEADER_KEYCODE(S(KC_R), KC_R)
+    U_LEADER_KEYCODE(S(KC_S), KC_S)
+    U_LEADER_KEYCODE(S(KC_T), KC_T)
+    U_LEADER_KEYCODE(S(KC_U), KC_U)
+    U_LEADER_KEYCODE(S(KC_V), KC_V)
+    U_LEADER_KEYCODE(S(KC_W), KC_W)
+    U_LEADER_KEYCODE(S(KC_X), KC_X)
+    U_LEADER_KEYCODE(S(KC_Y), KC_Y)
+    U_LEADER_KEYCODE(S(KC_Z), KC_Z)
+    U_LEADER_KEYCODE(S(KC_QUOT), KC_QUOT)
+    U_LEADER_KEYCODE(S(KC_SLSH), KC_SLSH)
+    U_LEADER_STRING(", ", KC_SPACE)
+};
+
+static uint16_t u_leader_keys[U_LEADER_SEQUENCE_MAX];
+static uint8_t u_leader_length;
+
+// Returns the sequence matching the typed keys exactly, or -1
+static int8_t u_leader_search(bool *extendable) {
+    int8_t exact = -1;
+    *extendable = false;
+    if (u_leader_length > U_LEADER_SEQUENCE_MAX) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(u_leader_sequences); i++) {
+        uint8_t j = 0;
+        while (j < u_leader_length && pgm_read_word(&u_leader_sequences[i].keys[j]) == u_leader_keys[j]) {
+            j++;
+        }
+        if (j < u_leader_length) {
+            continue;
+        }
+        if (j == U_LEADER_SEQUENCE_MAX || pgm_read_word(&u_leader_sequences[i].keys[j]) == KC_NO) {
+            exact = i;
+        } else {
+            *extendable = true;
+        }
+    }
+    return exact;
+}
+
+void leader_start_user(void) {
+    u_leader_length = 0;
+}
+
+bool leader_add_user(uint16_t keycode) {
+    if (u_leader_length < U_LEADER_SEQUENCE_MAX) {
+        u_leader_keys[u_leader_length] = keycode;
+    }
+    u_leader_length++;
+
+    bool extendable;
+    u_leader_search(&extendable);
+    return !extendable;
+}
+
 void leader_end_user(void) {
-    if        (leader_sequence_one_key(KC_A)) {
-        tap_code16(S(KC_A));
-    } else if (leader_sequence_one_key(KC_B)) {
-        tap_code16(S(KC_B));
-    } else if (leader_sequence_one_key(KC_C)) {
-        tap_code16(S(KC_C));
-    } else if (leader_sequence_one_key(KC_D)) {
-        tap_code16(S(KC_D));
-    } else if (leader_sequence_one_key(KC_E)) {
-        tap_code16(S(KC_E));
-    } else if (leader_sequence_one_key(KC_F)) {
-        tap_code16(S(KC_F));
-    } else if (leader_sequence_one_key(KC_G)) {
-        tap_code16(S(KC_G));
-    } else if (leader_sequence_one_key(KC_H)) {
-        tap_code16(S(KC_H));
-    } else if (leader_sequence_one_key(KC_I)) {
-        tap_code16(S(KC_I));
-    } else if (leader_sequence_one_key(KC_J)) {
-        tap_code16(S(KC_J));
-    } else if (leader_sequence_one_key(KC_K)) {
-        tap_code16(S(KC_K));
-    } else if (leader_sequence_one_key(KC_L)) {
-        tap_code16(S(KC_L));
-    } else if (leader_sequence_one_key(KC_M)) {
-        tap_code16(S(KC_M));
-    } else if (leader_sequence_one_key(KC_N)) {
-        tap_code16(S(KC_N));
-    } else if (leader_sequence_one_key(KC_O)) {
-        tap_code16(S(KC_O));
-    } else if (leader_sequence_one_key(KC_P)) {
-        tap_code16(S(KC_P));
-    } else if (leader_sequence_one_key(KC_Q)) {
-        tap_code16(S(KC_Q));
-    } else if (leader_sequence_one_key(KC_R)) {
-        tap_code16(S(KC_R));
-    } else if (leader_sequence_one_key(KC_S)) {
-        tap_code16(S(KC_S));
-    } else if (leader_sequence_one_key(KC_T)) {
-        tap_code16(S(KC_T));
-    } else if (leader_sequence_one_key(KC_U)) {
-        tap_code16(S(KC_U));
-    } else if (leader_sequence_one_key(KC_V)) {
-        tap_code16(S(KC_V));
-    } else if (leader_sequence_one_key(KC_W)) {
-        tap_code16(S(KC_W));
-    } else if (leader_sequence_one_key(KC_X)) {
-        tap_code16(S(KC_X));
-    } else if (leader_sequence_one_key(KC_Y)) {
-        tap_code16(S(KC_Y));
-    } else if (leader_sequence_one_key(KC_Z)) {
-        tap_code16(S(KC_Z));
-    } else if (leader_sequence_one_key(KC_QUOT)) {
-        tap_code16(S(KC_QUOT));
-    } else if (leader_sequence_one_key(KC_SLSH)) {
-        tap_code16(S(KC_SLSH));
-    } else if (leader_sequence_one_key(KC_SPACE)) {
-        send_string(", ");
+    bool extendable;
+    int8_t index = u_leader_search(&extendable);
+    if (index < 0) {
+        u_output_tap(KC_COMM);
+        return;
+    }
+    const char *string = pgm_read_ptr(&u_leader_sequences[index].string);
+    if (string) {
+        u_output_send_string(string);
     } else {
-        tap_code(KC_COMM);
+        u_output_tap(pgm_read_word(&u_leader_sequences[index].keycode));
     }
 }
@@ -16,10 +16,28 @@ MIRYOKU_LAYER_LIST
 
 #define U_MACRO_VA_ARGS(macro, ...) macro(__VA_ARGS__)
 
+// key position in the miryoku 10x4 grid, K00..K39, independent of keyboard
+#define U_KEY_INDEX_COUNT 40
+#define U_KEY_INDEX_NONE 0xFF
+#define U_KEY_INDEX_COL(index) ((index) % 10)
+#define U_KEY_INDEX_ROW(index) ((index) / 10)
+#define U_KEY_INDEX_HAND(index) (U_KEY_INDEX_COL(index) < 5 ? 'L' : 'R')
+#define U_KEY_INDEX_IS_THUMB(index) (U_KEY_INDEX_ROW(index) == 3)
+
+// raw HID command ids, first byte of every report
+enum miryoku_hid_commands {
+    U_HID_RECORDER = 0x01,
+    U_HID_PROFILER = 0x02,
+    U_HID_TELEMETRY = 0x03,
+    U_HID_UNHANDLED = 0xFF,
+};
+
 #if !defined (MIRYOKU_MAPPING)
   #define MIRYOKU_MAPPING LAYOUT_miryoku
 #endif
 
+uint8_t u_key_index(keypos_t key);
+
 #define U_NP KC_NO // key is not present
 #define U_NA KC_NO // present but not available for use
 #define U_NU KC_NO // available but not used
@@ -0,0 +1,81 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_autoshift.h"
+#include "miryoku_output.h"
+#include "manna-harbour_miryoku.h"
+
+uint16_t u_autoshift_timeout(uint16_t keycode, keyrecord_t *record) {
+    if (layer_switch_get_layer(record->event.key) == U_NUM) {
+        return MIRYOKU_AUTO_SHIFT_TIMEOUT_NUM;
+    }
+    return AUTO_SHIFT_TIMEOUT;
+}
+
+#if defined(MIRYOKU_AUTO_SHIFT_EAGER)
+
+static struct {
+    bool     held;    // the key's release is handled here
+    bool     pending; // unshifted key sent, may still become shifted
+    keypos_t key;
+    uint16_t keycode;
+    uint16_t time;
+    uint16_t timeout;
+} u_autoshift_eager;
+
+// Letters, numbers and punctuation, whose unshifted character backspace removes
+static bool u_autoshift_eager_printable(uint16_t keycode) {
+    return (keycode >= KC_A && keycode <= KC_0) || (keycode >= KC_MINS && keycode <= KC_SLSH);
+}
+
+// Returns false for the events handled here, bypassing QMK's Auto Shift
+bool u_autoshift_eager_process(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        if (u_autoshift_eager.held && KEYEQ(u_autoshift_eager.key, record->event.key)) {
+            u_autoshift_eager.held    = false;
+            u_autoshift_eager.pending = false;
+            return false;
+        }
+        return true;
+    }
+
+    // Any other press settles the previous key as it was sent
+    u_autoshift_eager.pending = false;
+
+    if (!u_autoshift_eager_printable(keycode) || !get_autoshift_state() || !get_auto_shifted_key(keycode, record) || get_mods() || get_oneshot_mods()) {
+        return true;
+    }
+#    if defined(LEADER_ENABLE)
+    // Leave keys to an active leader sequence, which runs after this hook
+    if (leader_sequence_active()) {
+        return true;
+    }
+#    endif
+
+    u_output_tap(keycode);
+    u_autoshift_eager.held    = true;
+    u_autoshift_eager.pending = true;
+    u_autoshift_eager.key     = record->event.key;
+    u_autoshift_eager.keycode = keycode;
+    u_autoshift_eager.time    = record->event.time;
+    u_autoshift_eager.timeout = get_autoshift_timeout(keycode, record);
+    return false;
+}
+
+void u_autoshift_eager_task(void) {
+    if (u_autoshift_eager.pending && timer_elapsed(u_autoshift_eager.time) >= u_autoshift_eager.timeout) {
+        u_output_tap(KC_BSPC);
+        u_output_tap(LSFT(u_autoshift_eager.keycode));
+        u_autoshift_eager.pending = false;
+    }
+}
+
+#else
+
+bool u_autoshift_eager_process(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+void u_autoshift_eager_task(void) {}
+
+#endif
@@ -0,0 +1,21 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Auto Shift timeout per key: shorter on the NUM layer, where numbers and the
+// symbols beside them are typed in runs.
+#if !defined(MIRYOKU_AUTO_SHIFT_TIMEOUT_NUM)
+#    define MIRYOKU_AUTO_SHIFT_TIMEOUT_NUM 150
+#endif
+
+// Eager Auto Shift: the unshifted key is sent on press instead of on release,
+// and if the key is still held at the timeout it is replaced by backspace and
+// the shifted key, all sent through the output queue. Only for letters,
+// numbers and punctuation without mods held.
+
+uint16_t u_autoshift_timeout(uint16_t keycode, keyrecord_t *record);
+bool     u_autoshift_eager_process(uint16_t keycode, keyrecord_t *record);
+void     u_autoshift_eager_task(void);
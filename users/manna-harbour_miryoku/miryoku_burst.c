@@ -0,0 +1,51 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_burst.h"
+
+_Static_assert(MIRYOKU_BURST_IKI < MIRYOKU_SLOW_IKI, "MIRYOKU_BURST_IKI must be below MIRYOKU_SLOW_IKI");
+
+// Fixed point, 1/16 ms. Samples are capped so a pause reads as slow without
+// taking long to recover from.
+#define U_BURST_SHIFT 4
+#define U_BURST_IKI_MAX (2 * MIRYOKU_SLOW_IKI)
+
+static uint16_t u_burst_iki = MIRYOKU_SLOW_IKI << U_BURST_SHIFT;
+static uint16_t u_burst_prev_time;
+static bool     u_burst_started;
+
+void u_burst_pre_process(keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return;
+    }
+
+    if (u_burst_started) {
+        uint16_t sample = MIN(TIMER_DIFF_16(record->event.time, u_burst_prev_time), U_BURST_IKI_MAX) << U_BURST_SHIFT;
+        // 1/4 weight on the new sample, so a burst registers within a few keys
+        u_burst_iki += ((int16_t)(sample - u_burst_iki)) / 4;
+    }
+    u_burst_started   = true;
+    u_burst_prev_time = record->event.time;
+}
+
+static uint16_t u_burst_interpolate(uint16_t burst, uint16_t slow) {
+    const uint16_t iki = u_burst_iki >> U_BURST_SHIFT;
+
+    if (iki <= MIRYOKU_BURST_IKI) {
+        return burst;
+    }
+    if (iki >= MIRYOKU_SLOW_IKI) {
+        return slow;
+    }
+    return burst + (int32_t)(slow - burst) * (iki - MIRYOKU_BURST_IKI) / (MIRYOKU_SLOW_IKI - MIRYOKU_BURST_IKI);
+}
+
+#if defined(FLOW_TAP_TERM)
+uint16_t u_burst_flow_tap_term(void) {
+    return u_burst_interpolate(MIRYOKU_FLOW_TAP_TERM_BURST, MIRYOKU_FLOW_TAP_TERM_SLOW);
+}
+#endif
+
+uint16_t u_burst_quick_tap_term(void) {
+    return u_burst_interpolate(MIRYOKU_QUICK_TAP_TERM_BURST, MIRYOKU_QUICK_TAP_TERM_SLOW);
+}
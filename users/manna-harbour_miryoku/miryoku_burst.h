@@ -0,0 +1,38 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Typing burst mode: an exponential moving average of the interval between
+// presses sets the flow tap and quick tap terms. At MIRYOKU_BURST_IKI or faster
+// the burst terms apply, so tap-hold keys typed mid-word resolve as taps at
+// once; at MIRYOKU_SLOW_IKI or slower the slow terms leave tap-hold keys mostly
+// to permissive and chordal hold. In between the terms are interpolated. The
+// defaults are derived from the configured FLOW_TAP_TERM and QUICK_TAP_TERM.
+
+#if !defined(MIRYOKU_BURST_IKI)
+#    define MIRYOKU_BURST_IKI 100
+#endif
+#if !defined(MIRYOKU_SLOW_IKI)
+#    define MIRYOKU_SLOW_IKI 250
+#endif
+#if defined(FLOW_TAP_TERM)
+#    if !defined(MIRYOKU_FLOW_TAP_TERM_BURST)
+#        define MIRYOKU_FLOW_TAP_TERM_BURST (FLOW_TAP_TERM + 50)
+#    endif
+#    if !defined(MIRYOKU_FLOW_TAP_TERM_SLOW)
+#        define MIRYOKU_FLOW_TAP_TERM_SLOW (FLOW_TAP_TERM / 2)
+#    endif
+#endif
+#if !defined(MIRYOKU_QUICK_TAP_TERM_BURST)
+#    define MIRYOKU_QUICK_TAP_TERM_BURST (QUICK_TAP_TERM + 50)
+#endif
+#if !defined(MIRYOKU_QUICK_TAP_TERM_SLOW)
+#    define MIRYOKU_QUICK_TAP_TERM_SLOW QUICK_TAP_TERM
+#endif
+
+void     u_burst_pre_process(keyrecord_t *record);
+uint16_t u_burst_flow_tap_term(void);
+uint16_t u_burst_quick_tap_term(void);
@@ -0,0 +1,36 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "miryoku_eeprom.h"
+
+#if U_EEPROM_SIZE > 0
+
+typedef struct {
+    uint8_t  magic;
+    uint8_t  version;
+    uint16_t telemetry_size;
+    uint16_t tapping_term_size;
+} u_eeprom_header_t;
+
+_Static_assert(sizeof(u_eeprom_header_t) == U_EEPROM_HEADER_SIZE, "U_EEPROM_HEADER_SIZE out of date");
+
+void u_eeprom_init(void) {
+    const u_eeprom_header_t expected = {U_EEPROM_MAGIC, U_EEPROM_VERSION, U_EEPROM_TELEMETRY_SIZE, U_EEPROM_TAPPING_TERM_SIZE};
+    u_eeprom_header_t       header   = {0};
+
+    if (eeconfig_is_user_datablock_valid()) {
+        eeconfig_read_user_datablock(&header, U_EEPROM_HEADER_OFFSET, sizeof(header));
+    }
+    if (memcmp(&header, &expected, sizeof(header))) {
+        eeconfig_init_user_datablock();
+        eeconfig_update_user_datablock(&expected, U_EEPROM_HEADER_OFFSET, sizeof(expected));
+    }
+}
+
+#else
+
+void u_eeprom_init(void) {}
+
+#endif
@@ -0,0 +1,17 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Header at the start of the EEPROM user datablock, see U_EEPROM_* in
+// config.h. The block offsets move as the persisting options are toggled, so
+// the header records the layout it was written with and a mismatch clears the
+// datablock instead of loading one option's data as another's.
+
+#define U_EEPROM_MAGIC 0x4D
+#define U_EEPROM_VERSION 1
+
+// Must run before any option reads its block
+void u_eeprom_init(void);
@@ -0,0 +1,23 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+// Little-endian serialisation for raw HID replies
+
+static inline uint8_t *u_put16(uint8_t *p, uint16_t v) {
+    *p++ = v & 0xFF;
+    *p++ = v >> 8;
+    return p;
+}
+
+static inline uint8_t *u_put32(uint8_t *p, uint32_t v) {
+    p = u_put16(p, v & 0xFFFF);
+    return u_put16(p, v >> 16);
+}
+
+static inline uint16_t u_get16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
@@ -0,0 +1,190 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_mouse.h"
+
+#if defined(MIRYOKU_HIRES_SCROLL)
+
+// Resolution multiplier units per step, or 1 where the host is not known to
+// apply the multiplier. macOS does not, and without OS detection the
+// clipboard option is the only hint of the host.
+#    define U_MOUSE_WHEEL_HIRES (POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER / MIRYOKU_HIRES_SCROLL_DIVISOR)
+
+static int16_t u_mouse_wheel_unit(void) {
+#    if defined(OS_DETECTION_ENABLE)
+    switch (detected_host_os()) {
+        case OS_LINUX:
+        case OS_WINDOWS:
+            return U_MOUSE_WHEEL_HIRES;
+        default:
+            return 1;
+    }
+#    elif defined(MIRYOKU_CLIPBOARD_MAC)
+    return 1;
+#    else
+    return U_MOUSE_WHEEL_HIRES;
+#    endif
+}
+
+#else
+
+static int16_t u_mouse_wheel_unit(void) {
+    return 1;
+}
+
+#endif
+
+void u_mouse_wheel(int8_t v, int8_t h) {
+    report_mouse_t report = mousekey_get_report();
+    int16_t        unit   = u_mouse_wheel_unit();
+
+    report.x = 0;
+    report.y = 0;
+    report.v = v * unit;
+    report.h = h * unit;
+    host_mouse_send(&report);
+}
+
+#if defined(MIRYOKU_MOUSE_KINETIC)
+
+_Static_assert(MIRYOKU_MOUSE_SPEED_MIN < MIRYOKU_MOUSE_SPEED_MAX, "MIRYOKU_MOUSE_SPEED_MIN must be below MIRYOKU_MOUSE_SPEED_MAX");
+_Static_assert(MIRYOKU_MOUSE_CURVE >= 1, "MIRYOKU_MOUSE_CURVE must be at least 1");
+
+enum u_mouse_dirs {
+    U_MOUSE_LEFT  = 1 << 0,
+    U_MOUSE_RIGHT = 1 << 1,
+    U_MOUSE_UP    = 1 << 2,
+    U_MOUSE_DOWN  = 1 << 3,
+};
+
+// Fixed point, 1/65536 pixel
+#    define U_MOUSE_SHIFT 16
+// 1/sqrt(2) in 1/256, for diagonals
+#    define U_MOUSE_DIAGONAL 181
+// Longest step integrated at once, so a stalled loop does not jump the pointer
+#    define U_MOUSE_DT_MAX 32
+
+static struct {
+    uint8_t  held;     // enum u_mouse_dirs
+    uint16_t start;    // first direction pressed
+    uint16_t time;     // last step
+    int16_t  speed[2]; // pixels per second, x and y
+    int32_t  rem[2];   // sub-pixel remainder, x and y
+} u_mouse;
+
+// Returns false for the cursor keys, which are moved here instead of by mousekeys
+bool u_mouse_process(uint16_t keycode, keyrecord_t *record) {
+    uint8_t dir;
+
+    switch (keycode) {
+        case MS_LEFT:
+            dir = U_MOUSE_LEFT;
+            break;
+        case MS_RGHT:
+            dir = U_MOUSE_RIGHT;
+            break;
+        case MS_UP:
+            dir = U_MOUSE_UP;
+            break;
+        case MS_DOWN:
+            dir = U_MOUSE_DOWN;
+            break;
+        default:
+            return true;
+    }
+
+    if (record->event.pressed) {
+        if (!u_mouse.held) {
+            u_mouse.start = record->event.time;
+            if (!u_mouse.speed[0] && !u_mouse.speed[1]) {
+                u_mouse.time = timer_read();
+            }
+        }
+        u_mouse.held |= dir;
+    } else {
+        u_mouse.held &= ~dir;
+    }
+    return false;
+}
+
+static uint16_t u_mouse_target(void) {
+    uint32_t t = MIN(timer_elapsed(u_mouse.start), MIRYOKU_MOUSE_TIME_TO_MAX);
+    // (t / MIRYOKU_MOUSE_TIME_TO_MAX) ^ MIRYOKU_MOUSE_CURVE, in 1/65536
+    uint32_t ramp = (t << 16) / MIRYOKU_MOUSE_TIME_TO_MAX;
+
+    for (uint8_t i = 1; i < MIRYOKU_MOUSE_CURVE; i++) {
+        ramp = ramp * t / MIRYOKU_MOUSE_TIME_TO_MAX;
+    }
+    return MIRYOKU_MOUSE_SPEED_MIN + ((uint32_t)(MIRYOKU_MOUSE_SPEED_MAX - MIRYOKU_MOUSE_SPEED_MIN) * ramp >> 16);
+}
+
+// Advances one axis by dt ms toward dir (-1, 0 or 1), returns whole pixels moved
+static int8_t u_mouse_axis(uint8_t axis, int8_t dir, uint16_t target, uint16_t dt) {
+    int16_t speed = u_mouse.speed[axis];
+
+    if (dir) {
+        // Keep a faster glide in the same direction rather than restart the ramp
+        speed = dir * MAX(target, dir * speed);
+    } else if (dt >= MIRYOKU_MOUSE_FRICTION) {
+        speed = 0;
+    } else {
+        speed -= (int32_t)speed * dt / MIRYOKU_MOUSE_FRICTION;
+        if (speed > -MIRYOKU_MOUSE_SPEED_MIN / 4 && speed < MIRYOKU_MOUSE_SPEED_MIN / 4) {
+            speed = 0;
+        }
+    }
+    u_mouse.speed[axis] = speed;
+    if (!speed) {
+        u_mouse.rem[axis] = 0;
+        return 0;
+    }
+
+    // pixels per second * ms, in 1/65536 pixel: * 65536 / 1000
+    int32_t rem  = u_mouse.rem[axis] + (int32_t)speed * dt * 8192 / 125;
+    int32_t move = rem / (1L << U_MOUSE_SHIFT);
+    move         = MIN(MAX(move, -127), 127);
+    u_mouse.rem[axis] = rem - move * (1L << U_MOUSE_SHIFT);
+    return move;
+}
+
+void u_mouse_task(void) {
+    if (!u_mouse.held && !u_mouse.speed[0] && !u_mouse.speed[1]) {
+        return;
+    }
+    uint16_t dt = timer_elapsed(u_mouse.time);
+    if (dt < MIRYOKU_MOUSE_INTERVAL) {
+        return;
+    }
+    u_mouse.time = timer_read();
+    dt           = MIN(dt, U_MOUSE_DT_MAX);
+
+    int8_t   dx     = !!(u_mouse.held & U_MOUSE_RIGHT) - !!(u_mouse.held & U_MOUSE_LEFT);
+    int8_t   dy     = !!(u_mouse.held & U_MOUSE_DOWN) - !!(u_mouse.held & U_MOUSE_UP);
+    uint16_t target = u_mouse_target();
+
+    if (dx && dy) {
+        target = (uint32_t)target * U_MOUSE_DIAGONAL / 256;
+    }
+
+    int8_t x = u_mouse_axis(0, dx, target, dt);
+    int8_t y = u_mouse_axis(1, dy, target, dt);
+
+    if (x || y) {
+        report_mouse_t report = mousekey_get_report();
+        report.x = x;
+        report.y = y;
+        report.v = 0;
+        report.h = 0;
+        host_mouse_send(&report);
+    }
+}
+
+#else
+
+bool u_mouse_process(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+void u_mouse_task(void) {}
+
+#endif
@@ -0,0 +1,51 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Wheel steps sent straight into the mouse report, keeping any mouse buttons
+// held by mousekeys. With MIRYOKU_HIRES_SCROLL each step is
+// 1/MIRYOKU_HIRES_SCROLL_DIVISOR of a detent in the units of the HID
+// resolution multiplier. Hosts that ignore the multiplier would read those
+// units as whole detents, so on those each step is a classic tick instead.
+
+void u_mouse_wheel(int8_t v, int8_t h);
+
+// Kinetic mouse keys: with MIRYOKU_MOUSE_KINETIC the cursor keys drive a
+// pointer whose speed ramps from MIRYOKU_MOUSE_SPEED_MIN to
+// MIRYOKU_MOUSE_SPEED_MAX (pixels per second) over MIRYOKU_MOUSE_TIME_TO_MAX
+// along a curve of power MIRYOKU_MOUSE_CURVE (1 linear, 2 quadratic, 3 cubic),
+// and glides to a stop after release, losing
+// 1/MIRYOKU_MOUSE_FRICTION of its speed each millisecond. Motion is
+// integrated in fixed point with the sub-pixel remainder carried over, and
+// reported every MIRYOKU_MOUSE_INTERVAL ms, the USB polling interval by
+// default, rather than every MOUSEKEY_INTERVAL. Diagonals are scaled by
+// 1/sqrt(2) so the pointer moves at the same speed in every direction.
+
+#if !defined(MIRYOKU_MOUSE_SPEED_MIN)
+#    define MIRYOKU_MOUSE_SPEED_MIN 200
+#endif
+#if !defined(MIRYOKU_MOUSE_SPEED_MAX)
+#    define MIRYOKU_MOUSE_SPEED_MAX 2400
+#endif
+#if !defined(MIRYOKU_MOUSE_TIME_TO_MAX)
+#    define MIRYOKU_MOUSE_TIME_TO_MAX 500
+#endif
+#if !defined(MIRYOKU_MOUSE_CURVE)
+#    define MIRYOKU_MOUSE_CURVE 2
+#endif
+#if !defined(MIRYOKU_MOUSE_FRICTION)
+#    define MIRYOKU_MOUSE_FRICTION 16
+#endif
+#if !defined(MIRYOKU_MOUSE_INTERVAL)
+#    if defined(USB_POLLING_INTERVAL_MS)
+#        define MIRYOKU_MOUSE_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define MIRYOKU_MOUSE_INTERVAL 1
+#    endif
+#endif
+
+bool u_mouse_process(uint16_t keycode, keyrecord_t *record);
+void u_mouse_task(void);
@@ -0,0 +1,199 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_output.h"
+
+enum u_output_ops {
+    U_OUTPUT_TAP,
+    U_OUTPUT_REGISTER,
+    U_OUTPUT_UNREGISTER,
+    U_OUTPUT_REGISTER_MODS,
+    U_OUTPUT_UNREGISTER_MODS,
+};
+
+typedef struct {
+    uint8_t  op;
+    uint16_t arg; // keycode or mods
+} u_output_t;
+
+static u_output_t u_output_queue[MIRYOKU_OUTPUT_QUEUE_SIZE];
+static uint8_t    u_output_head;
+static uint8_t    u_output_count;
+static uint16_t   u_output_held; // keycode pressed by the last step, KC_NO if none
+static uint16_t   u_output_time;
+
+// Key events held back behind queued output
+static keyevent_t u_output_events[MIRYOKU_OUTPUT_EVENTS];
+static uint8_t    u_output_events_head;
+static uint8_t    u_output_events_count;
+static bool       u_output_replaying;
+
+static bool u_output_idle(void) {
+    return !u_output_count && u_output_held == KC_NO;
+}
+
+// Sends one report's worth of output, returns false when there is none
+static bool u_output_step(void) {
+    if (u_output_held != KC_NO) {
+        unregister_code16(u_output_held);
+        u_output_held = KC_NO;
+        return true;
+    }
+    if (!u_output_count) {
+        return false;
+    }
+
+    u_output_t out = u_output_queue[u_output_head];
+    u_output_head  = (u_output_head + 1) % MIRYOKU_OUTPUT_QUEUE_SIZE;
+    u_output_count--;
+    switch (out.op) {
+        case U_OUTPUT_TAP:
+            register_code16(out.arg);
+            u_output_held = out.arg;
+            break;
+        case U_OUTPUT_REGISTER:
+            register_code16(out.arg);
+            break;
+        case U_OUTPUT_UNREGISTER:
+            unregister_code16(out.arg);
+            break;
+        case U_OUTPUT_REGISTER_MODS:
+            register_mods(out.arg);
+            break;
+        case U_OUTPUT_UNREGISTER_MODS:
+            unregister_mods(out.arg);
+            break;
+    }
+    return true;
+}
+
+static void u_output_push(uint8_t op, uint16_t arg) {
+    if (u_output_count == MIRYOKU_OUTPUT_QUEUE_SIZE) {
+        // Full, so fall back to sending what is queued now rather than drop
+        u_output_flush();
+    }
+    u_output_queue[(u_output_head + u_output_count) % MIRYOKU_OUTPUT_QUEUE_SIZE] = (u_output_t){op, arg};
+    u_output_count++;
+}
+
+void u_output_tap(uint16_t keycode) {
+    u_output_push(U_OUTPUT_TAP, keycode);
+}
+
+void u_output_send_string(const char *string) {
+    for (char ascii; (ascii = *string); string++) {
+        if ((uint8_t)ascii >= 128) {
+            continue;
+        }
+        uint16_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii]);
+        if ((pgm_read_byte(&ascii_to_shift_lut[ascii / 8]) >> (ascii % 8)) & 1) {
+            keycode = LSFT(keycode);
+        }
+        if ((pgm_read_byte(&ascii_to_altgr_lut[ascii / 8]) >> (ascii % 8)) & 1) {
+            keycode = RALT(keycode);
+        }
+        u_output_push(U_OUTPUT_TAP, keycode);
+    }
+}
+
+void u_output_register(uint16_t keycode) {
+    if (u_output_idle()) {
+        register_code16(keycode);
+    } else {
+        u_output_push(U_OUTPUT_REGISTER, keycode);
+    }
+}
+
+void u_output_unregister(uint16_t keycode) {
+    if (u_output_idle()) {
+        unregister_code16(keycode);
+    } else {
+        u_output_push(U_OUTPUT_UNREGISTER, keycode);
+    }
+}
+
+void u_output_register_mods(uint8_t mods) {
+    if (u_output_idle()) {
+        register_mods(mods);
+    } else {
+        u_output_push(U_OUTPUT_REGISTER_MODS, mods);
+    }
+}
+
+void u_output_unregister_mods(uint8_t mods) {
+    if (u_output_idle()) {
+        unregister_mods(mods);
+    } else {
+        u_output_push(U_OUTPUT_UNREGISTER_MODS, mods);
+    }
+}
+
+// Sends everything queued now, waiting TAP_CODE_DELAY between press and release
+void u_output_flush(void) {
+    while (u_output_step()) {
+        if (u_output_held != KC_NO) {
+            wait_ms(TAP_CODE_DELAY);
+        }
+    }
+}
+
+// Replays held back key events while nothing is queued. An event that queues
+// output holds back the ones after it again.
+static void u_output_replay(void) {
+    while (u_output_events_count && u_output_idle()) {
+        keyevent_t event     = u_output_events[u_output_events_head];
+        u_output_events_head = (u_output_events_head + 1) % MIRYOKU_OUTPUT_EVENTS;
+        u_output_events_count--;
+        u_output_replaying = true;
+        action_exec(event);
+        u_output_replaying = false;
+    }
+}
+
+// Called first in pre_process_record_user(), returns false for a key event
+// held back until the queued output has been sent
+bool u_output_pre_process(keyrecord_t *record) {
+    if (u_output_replaying || (u_output_idle() && !u_output_events_count)) {
+        return true;
+    }
+    if (u_output_events_count == MIRYOKU_OUTPUT_EVENTS) {
+        // Full, so fall back to sending the output now rather than drop keys
+        u_output_flush();
+        u_output_replay();
+        if (!u_output_events_count) {
+            return true;
+        }
+    }
+    u_output_events[(u_output_events_head + u_output_events_count) % MIRYOKU_OUTPUT_EVENTS] = record->event;
+    u_output_events_count++;
+    return false;
+}
+
+// Drops everything queued and releases any key pressed by the queue. Queued
+// key and modifier releases are applied, so nothing registered earlier is left
+// stuck,
+// and held back key events are replayed so no press loses its release.
+void u_output_clear(void) {
+    if (u_output_held != KC_NO) {
+        unregister_code16(u_output_held);
+        u_output_held = KC_NO;
+    }
+    for (; u_output_count; u_output_count--) {
+        const u_output_t *out = &u_output_queue[u_output_head];
+        if (out->op == U_OUTPUT_UNREGISTER) {
+            unregister_code16(out->arg);
+        } else if (out->op == U_OUTPUT_UNREGISTER_MODS) {
+            unregister_mods(out->arg);
+        }
+        u_output_head = (u_output_head + 1) % MIRYOKU_OUTPUT_QUEUE_SIZE;
+    }
+    u_output_replay();
+}
+
+void u_output_task(void) {
+    if (!u_output_idle() && timer_elapsed(u_output_time) >= MIRYOKU_OUTPUT_INTERVAL) {
+        u_output_time = timer_read();
+        u_output_step();
+    }
+    u_output_replay();
+}
@@ -0,0 +1,42 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Output queue: taps, key and modifier changes and short strings are queued
+// and sent from the housekeeping loop, one HID report per
+// MIRYOKU_OUTPUT_INTERVAL ms (the USB polling interval by default), so the
+// caller never waits out TAP_CODE_DELAY and matrix scanning is not stalled. A
+// tap is pressed on one step and released on the next. Key and modifier
+// changes made through the queue keep their order relative to queued taps, and
+// are applied at once when nothing is queued. Key events arriving while output
+// is queued are held back and replayed in order once it has been sent, so
+// queued output never lands after a later key. Only an overflow of either
+// buffer sends the queue at once.
+
+#if !defined(MIRYOKU_OUTPUT_QUEUE_SIZE)
+#    define MIRYOKU_OUTPUT_QUEUE_SIZE 32
+#endif
+#if !defined(MIRYOKU_OUTPUT_EVENTS)
+#    define MIRYOKU_OUTPUT_EVENTS 8
+#endif
+#if !defined(MIRYOKU_OUTPUT_INTERVAL)
+#    if defined(USB_POLLING_INTERVAL_MS)
+#        define MIRYOKU_OUTPUT_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define MIRYOKU_OUTPUT_INTERVAL 1
+#    endif
+#endif
+
+void u_output_tap(uint16_t keycode);
+void u_output_send_string(const char *string);
+void u_output_register(uint16_t keycode);
+void u_output_unregister(uint16_t keycode);
+void u_output_register_mods(uint8_t mods);
+void u_output_unregister_mods(uint8_t mods);
+void u_output_flush(void);
+bool u_output_pre_process(keyrecord_t *record);
+void u_output_clear(void);
+void u_output_task(void);
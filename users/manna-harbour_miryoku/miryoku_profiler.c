@@ -0,0 +1,171 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "miryoku_profiler.h"
+#include "miryoku_timer.h"
+#include "miryoku_hid.h"
+
+#define U_PROFILER_BUCKETS 32
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    // bucket n holds spans of [2^(n-1), 2^n) ticks; halved together on
+    // saturation so the distribution, and with it p99, is kept
+    uint16_t hist[U_PROFILER_BUCKETS];
+} u_profiler_slot_t;
+
+static u_profiler_slot_t u_profiler_slots[U_PROFILER_SLOTS];
+static uint32_t          u_profiler_start[U_PROFILER_SLOTS];
+
+static void u_profiler_add(uint8_t slot, uint32_t ticks) {
+    u_profiler_slot_t *s      = &u_profiler_slots[slot];
+    uint8_t            bucket = 0;
+
+    for (uint32_t t = ticks; t; t >>= 1) {
+        bucket++;
+    }
+    if (bucket >= U_PROFILER_BUCKETS) {
+        bucket = U_PROFILER_BUCKETS - 1;
+    }
+    if (s->hist[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < U_PROFILER_BUCKETS; i++) {
+            s->hist[i] >>= 1;
+        }
+    }
+    s->hist[bucket]++;
+
+    if (!s->count || ticks < s->min) {
+        s->min = ticks;
+    }
+    if (ticks > s->max) {
+        s->max = ticks;
+    }
+    s->sum += ticks;
+    s->count++;
+}
+
+void u_profiler_begin(uint8_t slot) {
+    u_profiler_start[slot] = u_timer_read_ticks();
+}
+
+void u_profiler_end(uint8_t slot) {
+    u_profiler_add(slot, u_timer_read_ticks() - u_profiler_start[slot]);
+}
+
+// Upper bound of the bucket holding the 99th percentile
+static uint32_t u_profiler_p99(const u_profiler_slot_t *s) {
+    uint32_t total = 0;
+    uint32_t seen  = 0;
+    uint8_t  i;
+
+    for (i = 0; i < U_PROFILER_BUCKETS; i++) {
+        total += s->hist[i];
+    }
+    for (i = 0; i < U_PROFILER_BUCKETS - 1; i++) {
+        seen += s->hist[i];
+        if (seen * 100 >= total * 99) {
+            break;
+        }
+    }
+    return i ? (1UL << i) - 1 : 0;
+}
+
+void u_profiler_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case U_PROFILER_HID_INFO:
+            data[2] = U_PROFILER_SLOTS;
+            u_put32(&data[3], U_TIMER_TICKS_PER_MS);
+            break;
+
+        case U_PROFILER_HID_READ: {
+            const u_profiler_slot_t *s = &u_profiler_slots[data[2] % U_PROFILER_SLOTS];
+            uint8_t                 *p = &data[3];
+
+            p = u_put32(p, s->count);
+            p = u_put32(p, s->min);
+            p = u_put32(p, s->count ? s->sum / s->count : 0);
+            p = u_put32(p, u_profiler_p99(s));
+            p = u_put32(p, s->max);
+            break;
+        }
+
+        case U_PROFILER_HID_RESET:
+            memset(u_profiler_slots, 0, sizeof(u_profiler_slots));
+            break;
+    }
+}
+
+// Link-time wrappers, enabled per task by -Wl,--wrap in post_rules.mk
+
+#define U_PROFILER_WRAP(SLOT, TYPE, NAME) \
+    TYPE __real_##NAME(void);             \
+    TYPE __wrap_##NAME(void) {            \
+        u_profiler_begin(SLOT);           \
+        TYPE ret = __real_##NAME();       \
+        u_profiler_end(SLOT);             \
+        return ret;                       \
+    }
+
+#define U_PROFILER_WRAP_VOID(SLOT, NAME) \
+    void __real_##NAME(void);            \
+    void __wrap_##NAME(void) {           \
+        u_profiler_begin(SLOT);          \
+        __real_##NAME();                 \
+        u_profiler_end(SLOT);            \
+    }
+
+U_PROFILER_WRAP(U_PROFILER_SCAN, uint8_t, matrix_scan)
+
+// Tick events, sent every scan without a key change, are timed apart from key
+// events. Only the outermost call is timed, as the tapping state machine calls
+// action_exec again when it replays buffered events.
+void __real_action_exec(keyevent_t event);
+void __wrap_action_exec(keyevent_t event) {
+    static bool active;
+
+    if (active) {
+        __real_action_exec(event);
+        return;
+    }
+    uint8_t slot = IS_EVENT(event) ? U_PROFILER_PROCESS : U_PROFILER_TICK;
+
+    active = true;
+    u_profiler_begin(slot);
+    __real_action_exec(event);
+    u_profiler_end(slot);
+    active = false;
+}
+
+#if defined(ENCODER_ENABLE)
+U_PROFILER_WRAP(U_PROFILER_ENCODER, bool, encoder_task)
+#endif
+
+#if defined(RGB_MATRIX_ENABLE)
+U_PROFILER_WRAP_VOID(U_PROFILER_RGB, rgb_matrix_task)
+#endif
+
+#if defined(DEFERRED_EXEC_ENABLE)
+U_PROFILER_WRAP_VOID(U_PROFILER_DEFERRED, deferred_exec_task)
+#endif
+
+// housekeeping_task() runs once at the end of every main loop pass, so the
+// span between entries is the pass itself
+void __real_housekeeping_task(void);
+void __wrap_housekeeping_task(void) {
+    static bool started;
+
+    if (started) {
+        u_profiler_end(U_PROFILER_LOOP);
+    }
+    started = true;
+    u_profiler_begin(U_PROFILER_LOOP);
+
+    u_profiler_begin(U_PROFILER_HOUSEKEEPING);
+    __real_housekeeping_task();
+    u_profiler_end(U_PROFILER_HOUSEKEEPING);
+}
@@ -0,0 +1,41 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Main loop profiler: time spent per pass in each firmware task, kept as
+// log2 histograms of timer ticks and read out over raw HID.
+//
+// The QMK tasks are timed by wrapping them at link time (see post_rules.mk), so
+// no core changes are needed. Userspace code can time its own spans with
+// u_profiler_begin()/u_profiler_end().
+
+#define U_PROFILER_SLOT_LIST \
+    U_PROFILER_X(LOOP)         /* whole main loop pass */ \
+    U_PROFILER_X(SCAN)         /* matrix scan, including split transport */ \
+    U_PROFILER_X(PROCESS)      /* action_exec for key events, i.e. process_record and tapping */ \
+    U_PROFILER_X(ENCODER)      /* encoder task */ \
+    U_PROFILER_X(RGB)          /* RGB matrix render and flush */ \
+    U_PROFILER_X(DEFERRED)     /* deferred exec callbacks */ \
+    U_PROFILER_X(HOUSEKEEPING) /* housekeeping task */ \
+    U_PROFILER_X(TICK)         /* action_exec for tick events, i.e. tapping timeouts */
+
+enum u_profiler_slots {
+#define U_PROFILER_X(SLOT) U_PROFILER_##SLOT,
+    U_PROFILER_SLOT_LIST
+#undef U_PROFILER_X
+    U_PROFILER_SLOTS
+};
+
+// Raw HID sub-commands of U_HID_PROFILER
+enum u_profiler_hid_commands {
+    U_PROFILER_HID_INFO,  // -> slots (u8), ticks per ms (u32)
+    U_PROFILER_HID_READ,  // slot (u8) -> count, min, avg, p99, max (u32 each, ticks)
+    U_PROFILER_HID_RESET, // clear all slots
+};
+
+void u_profiler_begin(uint8_t slot);
+void u_profiler_end(uint8_t slot);
+void u_profiler_raw_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,64 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_recorder.h"
+#include "miryoku_timer.h"
+#include "miryoku_hid.h"
+
+static u_recorder_event_t u_recorder_events[MIRYOKU_RECORDER_SIZE];
+
+// Count of events ever recorded; the ring slot is the low bits. The host reads
+// by sequence number so it can tell when entries were overwritten under it.
+static uint16_t u_recorder_head;
+
+void u_recorder_record(uint16_t keycode, keyrecord_t *record) {
+    u_recorder_event_t *event = &u_recorder_events[u_recorder_head & (MIRYOKU_RECORDER_SIZE - 1)];
+    uint8_t             flags = record->event.pressed ? U_RECORDER_PRESSED : 0;
+
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        flags |= record->tap.count ? U_RECORDER_TAP : U_RECORDER_HOLD;
+        if (record->tap.interrupted) {
+            flags |= U_RECORDER_INTERRUPTED;
+        }
+    }
+
+    event->time    = u_timer_read_us();
+    event->keycode = keycode;
+    event->delay   = timer_elapsed(record->event.time);
+    event->row     = record->event.key.row;
+    event->col     = record->event.key.col;
+    event->layer   = get_highest_layer(layer_state | default_layer_state);
+    event->flags   = flags;
+    u_recorder_head++;
+}
+
+void u_recorder_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case U_RECORDER_HID_INFO:
+            u_put16(u_put16(&data[2], u_recorder_head), MIRYOKU_RECORDER_SIZE);
+            break;
+
+        case U_RECORDER_HID_READ: {
+            uint16_t seq   = u_get16(&data[2]);
+            uint8_t *p     = u_put16(&data[2], u_recorder_head);
+            uint8_t *count = p++;
+
+            *count = 0;
+            // Only sequence numbers still in the ring are returned
+            while ((uint16_t)(u_recorder_head - seq) != 0 && (uint16_t)(u_recorder_head - seq) <= MIRYOKU_RECORDER_SIZE && p + U_RECORDER_HID_EVENT_SIZE <= data + length) {
+                const u_recorder_event_t *event = &u_recorder_events[seq & (MIRYOKU_RECORDER_SIZE - 1)];
+
+                p    = u_put32(p, event->time);
+                p    = u_put16(p, event->keycode);
+                p    = u_put16(p, event->delay);
+                *p++ = event->row;
+                *p++ = event->col;
+                *p++ = event->layer;
+                *p++ = event->flags;
+                (*count)++;
+                seq++;
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Keystroke flight recorder: a fixed ring of the most recent key events, read
+// out over raw HID while the keyboard keeps running.
+
+#if !defined(MIRYOKU_RECORDER_SIZE)
+#    if defined(__AVR__)
+#        define MIRYOKU_RECORDER_SIZE 16
+#    else
+#        define MIRYOKU_RECORDER_SIZE 256
+#    endif
+#endif
+
+_Static_assert((MIRYOKU_RECORDER_SIZE & (MIRYOKU_RECORDER_SIZE - 1)) == 0, "MIRYOKU_RECORDER_SIZE must be a power of two");
+
+enum u_recorder_flags {
+    U_RECORDER_PRESSED     = 1 << 0,
+    U_RECORDER_TAP         = 1 << 1, // tap-hold key resolved as tap
+    U_RECORDER_HOLD        = 1 << 2, // tap-hold key resolved as hold
+    U_RECORDER_INTERRUPTED = 1 << 3, // another key was pressed before resolution
+};
+
+typedef struct {
+    uint32_t time;    // u_timer_read_us() when the event was processed
+    uint16_t keycode; // keycode resolved from the layer state
+    uint16_t delay;   // ms from the matrix event to processing, i.e. decision latency
+    uint8_t  row;
+    uint8_t  col;
+    uint8_t  layer; // highest active layer
+    uint8_t  flags; // u_recorder_flags
+} u_recorder_event_t;
+
+// Raw HID sub-commands of U_HID_RECORDER
+enum u_recorder_hid_commands {
+    U_RECORDER_HID_INFO, // -> head (u16), size (u16)
+    U_RECORDER_HID_READ, // seq (u16) -> head (u16), count (u8), count events
+};
+
+#define U_RECORDER_HID_EVENT_SIZE 12
+
+void u_recorder_record(uint16_t keycode, keyrecord_t *record);
+void u_recorder_raw_hid(uint8_t *data, uint8_t length);
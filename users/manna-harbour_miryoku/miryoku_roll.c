@@ -0,0 +1,55 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_roll.h"
+
+// The most frequent English letter bigrams, excluding doubled letters. Keyed
+// by keycode rather than position, so the one table serves every alpha layout:
+// the selected base layer decides which entries start on a tap-hold key.
+static const uint8_t PROGMEM u_roll_bigrams[][2] = {
+    {KC_T, KC_H}, {KC_H, KC_E}, {KC_I, KC_N}, {KC_E, KC_R}, {KC_A, KC_N}, {KC_R, KC_E}, {KC_O, KC_N}, {KC_A, KC_T},
+    {KC_E, KC_N}, {KC_N, KC_D}, {KC_T, KC_I}, {KC_E, KC_S}, {KC_O, KC_R}, {KC_T, KC_E}, {KC_O, KC_F}, {KC_E, KC_D},
+    {KC_I, KC_S}, {KC_I, KC_T}, {KC_A, KC_L}, {KC_A, KC_R}, {KC_S, KC_T}, {KC_T, KC_O}, {KC_N, KC_T}, {KC_N, KC_G},
+    {KC_S, KC_E}, {KC_H, KC_A}, {KC_A, KC_S}, {KC_O, KC_U}, {KC_I, KC_O}, {KC_L, KC_E}, {KC_V, KC_E}, {KC_C, KC_O},
+    {KC_M, KC_E}, {KC_D, KC_E}, {KC_H, KC_I}, {KC_R, KC_I}, {KC_R, KC_O}, {KC_I, KC_C}, {KC_N, KC_E}, {KC_E, KC_A},
+    {KC_R, KC_A}, {KC_C, KC_E}, {KC_L, KC_I}, {KC_C, KC_H}, {KC_B, KC_E}, {KC_M, KC_A}, {KC_S, KC_I}, {KC_O, KC_M},
+    {KC_U, KC_R}, {KC_C, KC_A}, {KC_E, KC_L}, {KC_T, KC_A}, {KC_L, KC_A}, {KC_N, KC_S}, {KC_D, KC_I}, {KC_F, KC_O},
+    {KC_H, KC_O}, {KC_P, KC_E}, {KC_E, KC_C}, {KC_P, KC_R}, {KC_N, KC_O}, {KC_C, KC_T}, {KC_U, KC_S}, {KC_A, KC_C},
+    {KC_O, KC_T}, {KC_I, KC_L}, {KC_T, KC_R}, {KC_L, KC_Y}, {KC_N, KC_C}, {KC_E, KC_T}, {KC_U, KC_T}, {KC_S, KC_O},
+    {KC_R, KC_S}, {KC_U, KC_N}, {KC_L, KC_O}, {KC_W, KC_A}, {KC_G, KC_E}, {KC_I, KC_E}, {KC_W, KC_H}, {KC_W, KC_I},
+    {KC_E, KC_M}, {KC_A, KC_D}, {KC_O, KC_L}, {KC_R, KC_T}, {KC_P, KC_O}, {KC_W, KC_E}, {KC_N, KC_A}, {KC_U, KC_L},
+    {KC_N, KC_I}, {KC_T, KC_S}, {KC_M, KC_O}, {KC_O, KC_W}, {KC_P, KC_A}, {KC_I, KC_M}, {KC_M, KC_I}, {KC_A, KC_I},
+    {KC_S, KC_H}, {KC_I, KC_R}, {KC_S, KC_U}, {KC_I, KC_D}, {KC_O, KC_S}, {KC_I, KC_V}, {KC_I, KC_A}, {KC_A, KC_M},
+    {KC_F, KC_I}, {KC_C, KC_I}, {KC_V, KC_I}, {KC_P, KC_L}, {KC_I, KC_G}, {KC_T, KC_U}, {KC_E, KC_V}, {KC_L, KC_D},
+    {KC_R, KC_Y}, {KC_M, KC_P}, {KC_F, KC_E}, {KC_B, KC_L}, {KC_A, KC_B}, {KC_G, KC_H}, {KC_T, KC_Y}, {KC_O, KC_P},
+    {KC_W, KC_O}, {KC_S, KC_A}, {KC_A, KC_Y}, {KC_E, KC_X}, {KC_K, KC_E}, {KC_F, KC_R}, {KC_A, KC_V}, {KC_A, KC_G},
+};
+
+static uint16_t u_roll_tap_keycode(uint16_t keycode) {
+    if (IS_QK_MOD_TAP(keycode)) {
+        return QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    if (IS_QK_LAYER_TAP(keycode)) {
+        return QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    return keycode;
+}
+
+bool u_roll(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record) {
+    if (TIMER_DIFF_16(other_record->event.time, tap_hold_record->event.time) >= MIRYOKU_ROLL_TERM) {
+        return false;
+    }
+
+    const uint16_t first  = u_roll_tap_keycode(tap_hold_keycode);
+    const uint16_t second = u_roll_tap_keycode(other_keycode);
+
+    if (!IS_BASIC_KEYCODE(first) || !IS_BASIC_KEYCODE(second)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(u_roll_bigrams); i++) {
+        if (pgm_read_byte(&u_roll_bigrams[i][0]) == first && pgm_read_byte(&u_roll_bigrams[i][1]) == second) {
+            return true;
+        }
+    }
+    return false;
+}
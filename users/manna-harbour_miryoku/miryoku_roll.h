@@ -0,0 +1,16 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Frequent bigram rolls out of a tap-hold key. A tap-hold key followed within
+// MIRYOKU_ROLL_TERM by a key completing a frequent bigram is settled as tapped
+// at that press, rather than on release or at the tapping term.
+
+#if !defined(MIRYOKU_ROLL_TERM)
+#    define MIRYOKU_ROLL_TERM 100
+#endif
+
+bool u_roll(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record);
@@ -0,0 +1,28 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_tap_dance.h"
+#include "miryoku_output.h"
+
+void u_td_speculative_each_tap(tap_dance_state_t *state, void *user_data) {
+    const tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
+
+    if (state->count == 1) {
+        u_output_tap(pair->kc1);
+        return;
+    }
+    if (state->count == 2) {
+        u_output_tap(KC_BSPC);
+    } else {
+        u_output_unregister(pair->kc2);
+    }
+    u_output_register(pair->kc2);
+}
+
+void u_td_speculative_reset(tap_dance_state_t *state, void *user_data) {
+    const tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
+
+    if (state->count >= 2) {
+        u_output_unregister(pair->kc2);
+    }
+}
@@ -0,0 +1,22 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Speculative double tap dance: like ACTION_TAP_DANCE_DOUBLE, but kc1 is sent
+// on the first press instead of after the tapping term. The second tap erases
+// it with backspace and holds kc2 until the dance resets, so kc1 must be a key
+// that types exactly one character. Further taps stay on kc2, releasing and
+// pressing it again.
+//
+// Output goes through the output queue, so a keymap using it outside the
+// miryoku userspace must build miryoku_output.c and call u_output_pre_process()
+// and u_output_task() itself.
+
+void u_td_speculative_each_tap(tap_dance_state_t *state, void *user_data);
+void u_td_speculative_reset(tap_dance_state_t *state, void *user_data);
+
+#define ACTION_TAP_DANCE_SPECULATIVE(kc1, kc2) \
+    { .fn = {u_td_speculative_each_tap, NULL, u_td_speculative_reset, NULL}, .user_data = (void *)&((tap_dance_pair_t){kc1, kc2}), }
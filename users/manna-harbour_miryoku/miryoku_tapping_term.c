@@ -0,0 +1,163 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_tapping_term.h"
+#include "manna-harbour_miryoku.h"
+
+// Finger default by column within the hand, pinky first
+static const int8_t u_tapping_term_finger[] = {
+    MIRYOKU_TAPPING_TERM_PINKY, MIRYOKU_TAPPING_TERM_RING, MIRYOKU_TAPPING_TERM_MIDDLE, MIRYOKU_TAPPING_TERM_INDEX, MIRYOKU_TAPPING_TERM_INDEX,
+};
+
+static uint16_t u_tapping_term_default(uint8_t index) {
+    if (U_KEY_INDEX_IS_THUMB(index)) {
+        return TAPPING_TERM + MIRYOKU_TAPPING_TERM_THUMB;
+    }
+    uint8_t col = U_KEY_INDEX_COL(index);
+    return TAPPING_TERM + u_tapping_term_finger[col < 5 ? col : 9 - col];
+}
+
+#if defined(MIRYOKU_TAPPING_TERM_ADAPTIVE)
+
+// EEPROM image after the header, see miryoku_eeprom.h
+typedef struct __attribute__((packed)) {
+    uint16_t tap;  // average tap duration in 1/4 ms (8x 2 ms), 0 until the key has been tapped
+    uint8_t  bias; // misfire correction, 2 ms units
+} u_tapping_term_learned_t;
+
+static u_tapping_term_learned_t u_tapping_term_learned[U_KEY_INDEX_COUNT];
+
+_Static_assert(sizeof(u_tapping_term_learned) == U_EEPROM_TAPPING_TERM_SIZE, "U_EEPROM_TAPPING_TERM_SIZE out of date");
+
+// Last hold, for spotting a backspace correction after it
+static uint8_t  u_tapping_term_hold_index = U_KEY_INDEX_NONE;
+static uint8_t  u_tapping_term_hold_presses;
+static uint16_t u_tapping_term_hold_time;
+
+// Tap settled before release, whose duration says nothing about tapping
+static bool     u_tapping_term_settled_active;
+static keypos_t u_tapping_term_settled_key;
+
+static uint8_t  u_tapping_term_taps;
+static bool     u_tapping_term_dirty;
+static uint32_t u_tapping_term_flush_time;
+
+void u_tapping_term_init(void) {
+    // zeroed by u_eeprom_init() if written with another layout
+    eeconfig_read_user_datablock(u_tapping_term_learned, U_EEPROM_TAPPING_TERM_OFFSET, sizeof(u_tapping_term_learned));
+    u_tapping_term_flush_time = timer_read32();
+}
+
+void u_tapping_term_task(void) {
+    if (u_tapping_term_dirty && timer_elapsed32(u_tapping_term_flush_time) >= MIRYOKU_TAPPING_TERM_FLUSH_INTERVAL) {
+        eeconfig_update_user_datablock(u_tapping_term_learned, U_EEPROM_TAPPING_TERM_OFFSET, sizeof(u_tapping_term_learned));
+        u_tapping_term_dirty      = false;
+        u_tapping_term_flush_time = timer_read32();
+    }
+}
+
+static void u_tapping_term_tapped(uint8_t index, uint16_t duration) {
+    u_tapping_term_learned_t *learned = &u_tapping_term_learned[index];
+    uint16_t                  units   = MIN(duration / 2, UINT8_MAX);
+
+    // Exponential moving average, 1/8 weight on the new sample, kept scaled by
+    // 8 so small differences are not truncated away
+    learned->tap = learned->tap ? learned->tap + units - (learned->tap >> 3) : units << 3;
+    if (learned->bias && !(++u_tapping_term_taps % 32)) {
+        learned->bias--;
+    }
+    u_tapping_term_dirty = true;
+}
+
+static void u_tapping_term_misfired(uint8_t index) {
+    u_tapping_term_learned_t *learned = &u_tapping_term_learned[index];
+
+    learned->bias        = MIN(learned->bias + MIRYOKU_TAPPING_TERM_MISFIRE_STEP / 2, MIRYOKU_TAPPING_TERM_RANGE / 2);
+    u_tapping_term_dirty = true;
+}
+
+static bool u_tapping_term_is_backspace(uint16_t keycode, keyrecord_t *record) {
+    if (IS_QK_LAYER_TAP(keycode) && record->tap.count) {
+        keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    } else if (IS_QK_MOD_TAP(keycode) && record->tap.count) {
+        keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    return keycode == KC_BSPC;
+}
+
+void u_tapping_term_record(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return;
+    }
+
+    if (u_tapping_term_hold_index != U_KEY_INDEX_NONE) {
+        if (u_tapping_term_is_backspace(keycode, record) && timer_elapsed(u_tapping_term_hold_time) < MIRYOKU_TAPPING_TERM_MISFIRE_WINDOW) {
+            u_tapping_term_misfired(u_tapping_term_hold_index);
+            u_tapping_term_hold_index = U_KEY_INDEX_NONE;
+        } else if (++u_tapping_term_hold_presses > 1) {
+            // Only the key rolled into the hold may come between
+            u_tapping_term_hold_index = U_KEY_INDEX_NONE;
+        }
+    }
+
+    if (!IS_QK_MOD_TAP(keycode) && !IS_QK_LAYER_TAP(keycode)) {
+        return;
+    }
+    uint8_t index = u_key_index(record->event.key);
+    if (index == U_KEY_INDEX_NONE) {
+        return;
+    }
+
+    if (record->tap.count) {
+        uint16_t duration = timer_elapsed(record->event.time);
+        bool     settled  = u_tapping_term_settled_active && KEYEQ(u_tapping_term_settled_key, record->event.key);
+
+        u_tapping_term_settled_active = false;
+        // Only taps decided by the release; flow taps resolve on press
+        if (!settled && duration >= 20) {
+            u_tapping_term_tapped(index, duration);
+        }
+    } else {
+        u_tapping_term_hold_index   = index;
+        u_tapping_term_hold_presses = 0;
+        u_tapping_term_hold_time    = record->event.time;
+    }
+}
+
+// Called when a tap is decided on another key's press (chordal hold, bigram
+// roll), so that it is not learned from
+void u_tapping_term_settled(keyrecord_t *tap_hold_record) {
+    u_tapping_term_settled_active = true;
+    u_tapping_term_settled_key    = tap_hold_record->event.key;
+}
+
+uint16_t u_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    uint8_t index = u_key_index(record->event.key);
+    if (index == U_KEY_INDEX_NONE) {
+        return TAPPING_TERM;
+    }
+
+    const u_tapping_term_learned_t *learned = &u_tapping_term_learned[index];
+    const int16_t                   base    = u_tapping_term_default(index);
+    int16_t                         term    = learned->tap ? (learned->tap >> 2) + MIRYOKU_TAPPING_TERM_MARGIN : base;
+
+    term += learned->bias * 2;
+    return MAX(MIN(term, base + MIRYOKU_TAPPING_TERM_RANGE), base - MIRYOKU_TAPPING_TERM_RANGE);
+}
+
+#else
+
+void u_tapping_term_init(void) {}
+
+void u_tapping_term_task(void) {}
+
+void u_tapping_term_record(uint16_t keycode, keyrecord_t *record) {}
+
+void u_tapping_term_settled(keyrecord_t *tap_hold_record) {}
+
+uint16_t u_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    uint8_t index = u_key_index(record->event.key);
+    return index == U_KEY_INDEX_NONE ? TAPPING_TERM : u_tapping_term_default(index);
+}
+
+#endif
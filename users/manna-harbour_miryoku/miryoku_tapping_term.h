@@ -0,0 +1,54 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Per-key tapping term: a per-finger default from the key's position in the
+// miryoku grid, optionally adapted to how long each key is actually held when
+// tapped, and lengthened when a hold is followed by a backspace correction.
+
+// Offsets from TAPPING_TERM per finger
+#if !defined(MIRYOKU_TAPPING_TERM_PINKY)
+#    define MIRYOKU_TAPPING_TERM_PINKY 30
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_RING)
+#    define MIRYOKU_TAPPING_TERM_RING 10
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_MIDDLE)
+#    define MIRYOKU_TAPPING_TERM_MIDDLE 0
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_INDEX)
+#    define MIRYOKU_TAPPING_TERM_INDEX -30
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_THUMB)
+#    define MIRYOKU_TAPPING_TERM_THUMB 0
+#endif
+
+// Adaptation: term follows the average tap duration plus MARGIN, within RANGE
+// of the finger default. A hold corrected by backspace within MISFIRE_WINDOW
+// adds MISFIRE_STEP, which decays again over following taps.
+#if !defined(MIRYOKU_TAPPING_TERM_MARGIN)
+#    define MIRYOKU_TAPPING_TERM_MARGIN 100
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_RANGE)
+#    define MIRYOKU_TAPPING_TERM_RANGE 50
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_MISFIRE_WINDOW)
+#    define MIRYOKU_TAPPING_TERM_MISFIRE_WINDOW 1000
+#endif
+#if !defined(MIRYOKU_TAPPING_TERM_MISFIRE_STEP)
+#    define MIRYOKU_TAPPING_TERM_MISFIRE_STEP 10
+#endif
+
+// Learned values flushed to EEPROM at most this often, to limit wear
+#if !defined(MIRYOKU_TAPPING_TERM_FLUSH_INTERVAL)
+#    define MIRYOKU_TAPPING_TERM_FLUSH_INTERVAL 600000
+#endif
+
+uint16_t u_tapping_term(uint16_t keycode, keyrecord_t *record);
+void     u_tapping_term_init(void);
+void     u_tapping_term_task(void);
+void     u_tapping_term_record(uint16_t keycode, keyrecord_t *record);
+void     u_tapping_term_settled(keyrecord_t *tap_hold_record);
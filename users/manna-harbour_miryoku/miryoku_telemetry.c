@@ -0,0 +1,218 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "miryoku_telemetry.h"
+#include "miryoku_hid.h"
+
+// EEPROM image after the header, see miryoku_eeprom.h
+typedef struct {
+    uint16_t keycode; // KC_NO marks a free slot
+    uint16_t count[U_TELEMETRY_PATHS];
+} u_telemetry_counts_t;
+
+_Static_assert(sizeof(u_telemetry_counts_t) == 2 + 2 * U_TELEMETRY_PATHS, "u_telemetry_counts_t must be packed");
+
+static u_telemetry_counts_t u_telemetry_counts[MIRYOKU_TELEMETRY_KEYS];
+static uint8_t              u_telemetry_hist[MIRYOKU_TELEMETRY_KEYS][U_TELEMETRY_PATHS][MIRYOKU_TELEMETRY_BUCKETS];
+
+_Static_assert(sizeof(u_telemetry_counts) + sizeof(u_telemetry_hist) <= MIRYOKU_TELEMETRY_RAM, "telemetry exceeds MIRYOKU_TELEMETRY_RAM, reduce MIRYOKU_TELEMETRY_KEYS or MIRYOKU_TELEMETRY_BUCKETS");
+
+// The unresolved tap-hold key, and the key pressed before it. QMK settles one
+// tapping key at a time so one is enough.
+typedef struct {
+    bool     active;
+    bool     speculative; // mods held from the press
+    uint8_t  decision;    // set by u_telemetry_decision(), else U_TELEMETRY_PATHS
+    keypos_t key;
+    uint16_t time;
+    uint16_t prev_keycode;
+    uint16_t prev_time;
+} u_telemetry_pending_t;
+
+static u_telemetry_pending_t u_telemetry_pending;
+
+// Longer than any tapping term, after which a pending key is forgotten
+#define U_TELEMETRY_STALE 1000
+
+static uint16_t u_telemetry_prev_keycode;
+static uint16_t u_telemetry_prev_time;
+
+#if defined(MIRYOKU_TELEMETRY_EEPROM)
+_Static_assert(sizeof(u_telemetry_counts) == U_EEPROM_TELEMETRY_SIZE, "U_EEPROM_TELEMETRY_SIZE out of date");
+
+static bool     u_telemetry_dirty;
+static uint32_t u_telemetry_flush_time;
+
+static void u_telemetry_flush(void) {
+    eeconfig_update_user_datablock(u_telemetry_counts, U_EEPROM_TELEMETRY_OFFSET, sizeof(u_telemetry_counts));
+    u_telemetry_dirty      = false;
+    u_telemetry_flush_time = timer_read32();
+}
+#endif
+
+void u_telemetry_init(void) {
+#if defined(MIRYOKU_TELEMETRY_EEPROM)
+    eeconfig_read_user_datablock(u_telemetry_counts, U_EEPROM_TELEMETRY_OFFSET, sizeof(u_telemetry_counts));
+    u_telemetry_flush_time = timer_read32();
+#endif
+}
+
+void u_telemetry_task(void) {
+#if defined(MIRYOKU_TELEMETRY_EEPROM)
+    if (u_telemetry_dirty && timer_elapsed32(u_telemetry_flush_time) >= MIRYOKU_TELEMETRY_FLUSH_INTERVAL) {
+        u_telemetry_flush();
+    }
+#endif
+}
+
+static bool u_telemetry_is_tap_hold(uint16_t keycode) {
+    return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+}
+
+// Called before the tapping logic buffers the event, so in physical order
+void u_telemetry_pre_process(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return;
+    }
+
+    // A press swallowed before process_record (e.g. by a combo) never resolves
+    if (u_telemetry_pending.active && TIMER_DIFF_16(record->event.time, u_telemetry_pending.time) > U_TELEMETRY_STALE) {
+        u_telemetry_pending.active = false;
+    }
+
+    if (!u_telemetry_pending.active && u_telemetry_is_tap_hold(keycode)) {
+        u_telemetry_pending.active       = true;
+        u_telemetry_pending.decision     = U_TELEMETRY_PATHS;
+        u_telemetry_pending.key          = record->event.key;
+        u_telemetry_pending.time         = record->event.time;
+        u_telemetry_pending.prev_keycode = u_telemetry_prev_keycode;
+        u_telemetry_pending.prev_time    = u_telemetry_prev_time;
+#if defined(SPECULATIVE_HOLD)
+        // the same question QMK asks on this press
+        u_telemetry_pending.speculative = IS_QK_MOD_TAP(keycode) && get_speculative_hold(keycode, record);
+#endif
+    }
+
+    u_telemetry_prev_keycode = keycode;
+    u_telemetry_prev_time    = record->event.time;
+}
+
+// Called from the tap-hold callbacks with the path their answer leads to. Only
+// kept if the key then resolves that way, as QMK may ask and decide otherwise.
+void u_telemetry_decision(keyrecord_t *tap_hold_record, uint8_t path) {
+    if (u_telemetry_pending.active && KEYEQ(u_telemetry_pending.key, tap_hold_record->event.key)) {
+        u_telemetry_pending.decision = path;
+    }
+}
+
+static uint8_t u_telemetry_path(uint16_t keycode, keyrecord_t *record, const u_telemetry_pending_t *pending) {
+    if (record->tap.count) {
+#if defined(FLOW_TAP_TERM)
+        if (pending->prev_keycode != KC_NO && TIMER_DIFF_16(record->event.time, pending->prev_time) < get_flow_tap_term(keycode, record, pending->prev_keycode)) {
+            return U_TELEMETRY_FLOW;
+        }
+#endif
+        if (pending->decision == U_TELEMETRY_CHORDAL) {
+            return U_TELEMETRY_CHORDAL;
+        }
+        if (pending->speculative) {
+            return U_TELEMETRY_ROLLBACK;
+        }
+        return U_TELEMETRY_TAP;
+    }
+
+    if (pending->decision == U_TELEMETRY_PERMISSIVE || pending->decision == U_TELEMETRY_CROSS_HAND) {
+        return pending->decision;
+    }
+    return U_TELEMETRY_TIMEOUT;
+}
+
+static u_telemetry_counts_t *u_telemetry_slot(uint16_t keycode) {
+    for (uint8_t i = 0; i < MIRYOKU_TELEMETRY_KEYS; i++) {
+        if (u_telemetry_counts[i].keycode == keycode || u_telemetry_counts[i].keycode == KC_NO) {
+            u_telemetry_counts[i].keycode = keycode;
+            return &u_telemetry_counts[i];
+        }
+    }
+    return NULL;
+}
+
+// Called with every processed event; counts the resolved press of a tap-hold key
+void u_telemetry_record(uint16_t keycode, keyrecord_t *record) {
+    if (!u_telemetry_is_tap_hold(keycode)) {
+        return;
+    }
+
+    u_telemetry_pending_t pending = {.decision = U_TELEMETRY_PATHS};
+
+    if (u_telemetry_pending.active && KEYEQ(u_telemetry_pending.key, record->event.key)) {
+        pending                    = u_telemetry_pending;
+        u_telemetry_pending.active = false;
+    }
+    if (!record->event.pressed) {
+        return;
+    }
+
+    const uint16_t        latency = timer_elapsed(record->event.time);
+    const uint8_t         path    = u_telemetry_path(keycode, record, &pending);
+    u_telemetry_counts_t *counts  = u_telemetry_slot(keycode);
+
+    if (!counts) {
+        return;
+    }
+
+    uint8_t  *hist   = u_telemetry_hist[counts - u_telemetry_counts][path];
+    uint8_t   bucket = MIN(latency / MIRYOKU_TELEMETRY_BUCKET_MS, MIRYOKU_TELEMETRY_BUCKETS - 1);
+
+    // Saturate rather than wrap
+    if (counts->count[path] < UINT16_MAX) {
+        counts->count[path]++;
+    }
+    if (hist[bucket] < UINT8_MAX) {
+        hist[bucket]++;
+    }
+#if defined(MIRYOKU_TELEMETRY_EEPROM)
+    u_telemetry_dirty = true;
+#endif
+}
+
+void u_telemetry_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case U_TELEMETRY_HID_INFO:
+            data[2] = MIRYOKU_TELEMETRY_KEYS;
+            data[3] = U_TELEMETRY_PATHS;
+            data[4] = MIRYOKU_TELEMETRY_BUCKETS;
+            u_put16(&data[5], MIRYOKU_TELEMETRY_BUCKET_MS);
+            break;
+
+        case U_TELEMETRY_HID_READ: {
+            const u_telemetry_counts_t *counts = &u_telemetry_counts[data[2] % MIRYOKU_TELEMETRY_KEYS];
+            uint8_t                    *p      = u_put16(&data[3], counts->keycode);
+
+            for (uint8_t i = 0; i < U_TELEMETRY_PATHS; i++) {
+                p = u_put16(p, counts->count[i]);
+            }
+            break;
+        }
+
+        case U_TELEMETRY_HID_HIST: {
+            const uint8_t  *hist = u_telemetry_hist[data[2] % MIRYOKU_TELEMETRY_KEYS][data[3] % U_TELEMETRY_PATHS];
+            uint8_t        *p    = &data[4];
+
+            for (uint8_t i = 0; i < MIRYOKU_TELEMETRY_BUCKETS && p + 2 <= data + length; i++) {
+                p = u_put16(p, hist[i]);
+            }
+            break;
+        }
+
+        case U_TELEMETRY_HID_RESET:
+            memset(u_telemetry_counts, 0, sizeof(u_telemetry_counts));
+            memset(u_telemetry_hist, 0, sizeof(u_telemetry_hist));
+#if defined(MIRYOKU_TELEMETRY_EEPROM)
+            u_telemetry_flush();
+#endif
+            break;
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Tap-hold decision telemetry: per mod-tap and layer-tap keycode, how often
+// each resolution path was taken and how long the decision took, read out over
+// raw HID and optionally kept across power cycles in the EEPROM user datablock.
+//
+// Hold paths and the chordal tap are recorded by the tap-hold callbacks in
+// manna-harbour_miryoku.c as QMK asks them, via u_telemetry_decision(). Flow
+// tap and speculative hold are decided on the press and are taken from the
+// same callbacks QMK consults there:
+//
+// - TAP: tap after release
+// - TIMEOUT: hold after the tapping term expired
+// - PERMISSIVE: hold granted by get_permissive_hold() on a nested tap
+// - CHORDAL: tap forced by get_chordal_hold(), same hand chord or roll
+// - FLOW: tap forced by pressing within the flow tap term of the previous key
+// - ROLLBACK: tap on a key whose mods were speculatively held
+// - CROSS_HAND: hold granted by get_hold_on_other_key_press()
+
+#define U_TELEMETRY_PATH_LIST \
+    U_TELEMETRY_X(TAP)        \
+    U_TELEMETRY_X(TIMEOUT)    \
+    U_TELEMETRY_X(PERMISSIVE) \
+    U_TELEMETRY_X(CHORDAL)    \
+    U_TELEMETRY_X(FLOW)       \
+    U_TELEMETRY_X(ROLLBACK)   \
+    U_TELEMETRY_X(CROSS_HAND)
+
+enum u_telemetry_paths {
+#define U_TELEMETRY_X(PATH) U_TELEMETRY_##PATH,
+    U_TELEMETRY_PATH_LIST
+#undef U_TELEMETRY_X
+    U_TELEMETRY_PATHS
+};
+
+// Latency histogram of MIRYOKU_TELEMETRY_BUCKETS linear buckets, the last one
+// open ended, with 8 bit saturating counts. The default covers the 250 ms
+// tapping term, more coarsely on AVR to fit in RAM.
+#if !defined(MIRYOKU_TELEMETRY_BUCKETS)
+#    if defined(__AVR__)
+#        define MIRYOKU_TELEMETRY_BUCKETS 4
+#    else
+#        define MIRYOKU_TELEMETRY_BUCKETS 8
+#    endif
+#endif
+#if !defined(MIRYOKU_TELEMETRY_BUCKET_MS)
+#    define MIRYOKU_TELEMETRY_BUCKET_MS (320 / MIRYOKU_TELEMETRY_BUCKETS)
+#endif
+
+// RAM budget for the counters and histograms
+#if !defined(MIRYOKU_TELEMETRY_RAM)
+#    if defined(__AVR__)
+#        define MIRYOKU_TELEMETRY_RAM 512
+#    else
+#        define MIRYOKU_TELEMETRY_RAM 4096
+#    endif
+#endif
+
+// Counters flushed to EEPROM at most this often, to limit wear
+#if !defined(MIRYOKU_TELEMETRY_FLUSH_INTERVAL)
+#    define MIRYOKU_TELEMETRY_FLUSH_INTERVAL 600000
+#endif
+
+// Raw HID sub-commands of U_HID_TELEMETRY
+enum u_telemetry_hid_commands {
+    U_TELEMETRY_HID_INFO,  // -> keys (u8), paths (u8), buckets (u8), bucket ms (u16)
+    U_TELEMETRY_HID_READ,  // key (u8) -> keycode (u16), count per path (u16 each)
+    U_TELEMETRY_HID_HIST,  // key (u8), path (u8) -> count per bucket (u16 each)
+    U_TELEMETRY_HID_RESET, // clear all keys, including the EEPROM copy
+};
+
+void u_telemetry_init(void);
+void u_telemetry_task(void);
+void u_telemetry_pre_process(uint16_t keycode, keyrecord_t *record);
+void u_telemetry_record(uint16_t keycode, keyrecord_t *record);
+void u_telemetry_decision(keyrecord_t *tap_hold_record, uint8_t path);
+void u_telemetry_raw_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,47 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "miryoku_timer.h"
+
+#if defined(U_TIMER_DWT)
+
+static uint32_t u_timer_last_cycles;
+static uint32_t u_timer_cycles_rem;
+static uint32_t u_timer_us;
+
+void u_timer_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    u_timer_last_cycles = 0;
+}
+
+uint32_t u_timer_read_us(void) {
+    const uint32_t now     = DWT->CYCCNT;
+    const uint32_t elapsed = now - u_timer_last_cycles + u_timer_cycles_rem;
+
+    u_timer_last_cycles = now;
+    u_timer_us += elapsed / U_TIMER_TICKS_PER_US;
+    u_timer_cycles_rem = elapsed % U_TIMER_TICKS_PER_US;
+    return u_timer_us;
+}
+
+void u_timer_task(void) {
+    u_timer_read_us();
+}
+
+#else
+
+void u_timer_init(void) {}
+
+void u_timer_task(void) {}
+
+uint32_t u_timer_read_us(void) {
+#    if defined(MCU_RP)
+    return u_timer_read_ticks();
+#    else
+    return u_timer_read_ticks() * 1000;
+#    endif
+}
+
+#endif
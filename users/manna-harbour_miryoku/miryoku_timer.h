@@ -0,0 +1,39 @@
+// Copyright 2026 thirteen37
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+// Microsecond timestamps for the userspace instrumentation.
+//
+// - RP2040: the free-running 1 MHz hardware timer
+// - Cortex-M3/M4/M7 STM32: the DWT cycle counter, extended in software since it
+//   wraps every few tens of seconds; u_timer_task() must run every main loop pass
+// - anything else: the millisecond system timer
+
+#if defined(MCU_RP)
+#    define U_TIMER_TICKS_PER_US 1
+#    define U_TIMER_TICKS_PER_MS 1000
+#elif defined(MCU_STM32) && defined(DWT)
+#    define U_TIMER_DWT
+#    define U_TIMER_TICKS_PER_US (STM32_SYSCLK / 1000000)
+#    define U_TIMER_TICKS_PER_MS (STM32_SYSCLK / 1000)
+#else
+#    define U_TIMER_TICKS_PER_MS 1
+#endif
+
+void     u_timer_init(void);
+void     u_timer_task(void);
+uint32_t u_timer_read_us(void);
+
+// Raw free-running counter at U_TIMER_TICKS_PER_MS, for timing short spans
+static inline uint32_t u_timer_read_ticks(void) {
+#if defined(U_TIMER_DWT)
+    return DWT->CYCCNT;
+#elif defined(MCU_RP)
+    return TIMER->TIMERAWL;
+#else
+    return timer_read32();
+#endif
+}
@@ -40,3 +40,92 @@ ifeq ($(strip $(MIRYOKU_KLUDGE_THUMBCOMBOS)),yes)
   COMBO_ENABLE = yes
   OPT_DEFS += -DMIRYOKU_KLUDGE_THUMBCOMBOS
 endif
+
+# tapping term
+
+# learn per-key tapping terms, persisted in EEPROM
+ifeq ($(strip $(MIRYOKU_TAPPING_TERM_ADAPTIVE)),yes)
+  OPT_DEFS += -DMIRYOKU_TAPPING_TERM_ADAPTIVE
+endif
+
+# settle a home row mod-tap as held on an opposite-hand press
+ifeq ($(strip $(MIRYOKU_INSTANT_HOLD)),yes)
+  OPT_DEFS += -DMIRYOKU_INSTANT_HOLD
+endif
+
+# settle a thumb layer-tap as held on an opposite-hand press, without rollback
+ifeq ($(strip $(MIRYOKU_EARLY_LAYER)),yes)
+  OPT_DEFS += -DMIRYOKU_EARLY_LAYER
+endif
+
+# auto shift
+
+# send the unshifted key on press, corrected at the timeout
+ifeq ($(strip $(MIRYOKU_AUTO_SHIFT_EAGER)),yes)
+  OPT_DEFS += -DMIRYOKU_AUTO_SHIFT_EAGER
+endif
+
+# tap dance
+
+# speculative double tap dance, for keymaps that enable tap dance
+ifeq ($(strip $(TAP_DANCE_ENABLE)),yes)
+  SRC += miryoku_tap_dance.c
+endif
+
+# mouse
+
+# wheel steps in units of the HID resolution multiplier
+ifeq ($(strip $(MIRYOKU_HIRES_SCROLL)),yes)
+  OPT_DEFS += -DMIRYOKU_HIRES_SCROLL
+endif
+
+# fixed-point kinetic pointer for the mouse cursor keys
+ifeq ($(strip $(MIRYOKU_MOUSE_KINETIC)),yes)
+  OPT_DEFS += -DMIRYOKU_MOUSE_KINETIC
+endif
+
+# instrumentation
+
+# keystroke flight recorder
+ifeq ($(strip $(MIRYOKU_RECORDER)),yes)
+  RAW_ENABLE = yes
+  MIRYOKU_TIMER = yes
+  OPT_DEFS += -DMIRYOKU_RECORDER
+  SRC += miryoku_recorder.c
+endif
+
+# main loop profiler
+# Tasks are timed by wrapping them at link time, which LTO would defeat.
+ifeq ($(strip $(MIRYOKU_PROFILER)),yes)
+  RAW_ENABLE = yes
+  MIRYOKU_TIMER = yes
+  LTO_ENABLE = no
+  OPT_DEFS += -DMIRYOKU_PROFILER
+  SRC += miryoku_profiler.c
+  EXTRALDFLAGS += -Wl,--wrap=matrix_scan -Wl,--wrap=action_exec -Wl,--wrap=housekeeping_task
+  ifeq ($(strip $(ENCODER_ENABLE)),yes)
+    EXTRALDFLAGS += -Wl,--wrap=encoder_task
+  endif
+  ifeq ($(strip $(RGB_MATRIX_ENABLE)),yes)
+    EXTRALDFLAGS += -Wl,--wrap=rgb_matrix_task
+  endif
+  ifeq ($(strip $(DEFERRED_EXEC_ENABLE)),yes)
+    EXTRALDFLAGS += -Wl,--wrap=deferred_exec_task
+  endif
+endif
+
+# tap-hold decision telemetry
+ifeq ($(strip $(MIRYOKU_TELEMETRY)),yes)
+  RAW_ENABLE = yes
+  OPT_DEFS += -DMIRYOKU_TELEMETRY
+  SRC += miryoku_telemetry.c
+  ifeq ($(strip $(MIRYOKU_TELEMETRY_EEPROM)),yes)
+    OPT_DEFS += -DMIRYOKU_TELEMETRY_EEPROM
+  endif
+endif
+
+# microsecond timestamps, pulled in by the instrumentation options
+ifeq ($(strip $(MIRYOKU_TIMER)),yes)
+  OPT_DEFS += -DMIRYOKU_TIMER
+  SRC += miryoku_timer.c
+endif
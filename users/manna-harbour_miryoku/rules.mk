@@ -4,12 +4,12 @@
 MOUSEKEY_ENABLE = yes
 EXTRAKEY_ENABLE = yes
 AUTO_SHIFT_ENABLE = yes
-TAP_DANCE_ENABLE = yes
 CAPS_WORD_ENABLE = yes
 KEY_OVERRIDE_ENABLE = yes
 LEADER_ENABLE = yes
 
 INTROSPECTION_KEYMAP_C = manna-harbour_miryoku.c # keymaps
+SRC += miryoku_tapping_term.c miryoku_roll.c miryoku_burst.c miryoku_autoshift.c miryoku_output.c miryoku_mouse.c miryoku_eeprom.c
 
 include $(QMK_USERSPACE)/users/manna-harbour_miryoku/custom_rules.mk
 
@@ -0,0 +1,147 @@
+#!/usr/bin/env bash
+# Attribute the flash and RAM of a QMK build to features and to individual
+# userspace symbols, using the linker map of the build.
+#
+# usage: footprint.sh <map file> [flash budget] [ram budget]
+#
+# Budgets are in bytes. When one is given and exceeded the script exits 1,
+# so `make footprint` fails before a keymap change becomes a link failure.
+
+set -euo pipefail
+
+MAP_FILE="${1:?usage: footprint.sh <map file> [flash budget] [ram budget]}"
+FLASH_BUDGET="${2:-}"
+RAM_BUDGET="${3:-}"
+
+if [ ! -f "$MAP_FILE" ]; then
+    echo "footprint: map file '$MAP_FILE' not found" >&2
+    exit 2
+fi
+
+awk -v flash_budget="$FLASH_BUDGET" -v ram_budget="$RAM_BUDGET" '
+function hex(s,    i, c, v) {
+    v = 0
+    s = tolower(s)
+    sub(/^0x/, "", s)
+    for (i = 1; i <= length(s); i++) {
+        c = index("0123456789abcdef", substr(s, i, 1))
+        v = v * 16 + c - 1
+    }
+    return v
+}
+
+# text: stored in flash only, data: flash and RAM, bss: RAM only
+function kind(section) {
+    if (section ~ /^\.(text|rodata|progmem|vectors|init|fini|trampolines|jumptables|ctors|dtors)/) return "text"
+    if (section ~ /^\.data/) return "data"
+    if (section ~ /^(\.bss|\.noinit|COMMON)/) return "bss"
+    return ""
+}
+
+function feature(file,    base) {
+    if (file ~ /\.a\(/) return "libc"
+    base = file
+    sub(/.*\//, "", base)
+    sub(/\.o$/, "", base)
+    if (file ~ /\/users\// || base == "keymap_introspection") return "userspace"
+    if (base == "keymap") return "keymap"
+    if (base ~ /leader/) return "leader"
+    if (base ~ /combo/) return "combo"
+    if (base ~ /tap_dance/) return "tap_dance"
+    if (base ~ /auto_shift/) return "auto_shift"
+    if (base ~ /mousekey/) return "mousekey"
+    if (base ~ /caps_word/) return "caps_word"
+    if (base ~ /key_override/) return "key_override"
+    if (base ~ /deferred_exec/) return "deferred_exec"
+    if (base ~ /encoder/) return "encoder"
+    if (base ~ /^rgb_matrix|^rgblight|ws2812/) return "rgb"
+    if (base ~ /^(split_util|transport|transactions|serial)/) return "split"
+    if (base ~ /ltrans/) return "lto"
+    if (file ~ /\/(chibios|lufa|lib|platforms)\//) return "platform"
+    return "core"
+}
+
+function add(section, size, file,    k, f, sym) {
+    k = kind(section)
+    if (k == "" || size == 0) return
+    f = feature(file)
+    total[f, k] += size
+    features[f] = 1
+    if (f == "userspace" || f == "keymap") {
+        sym = section
+        sub(/^\.(text|rodata|progmem\.data|progmem|data|bss)\.?/, "", sym)
+        if (sym == "" || sym == "COMMON") sym = "(" section ")"
+        symbols[sym, k] += size
+        symnames[sym] = 1
+    }
+}
+
+/^Linker script and memory map/ { in_map = 1; next }
+!in_map { next }
+/^\/DISCARD\// { discard = 1; next }
+/^[^ ]/ { discard = 0 }
+discard { next }
+
+# Input section on one line: " .text.foo 0xaddr 0xsize file"
+/^ [.A-Z]/ && NF >= 4 && $2 ~ /^0x/ && $3 ~ /^0x/ {
+    add($1, hex($3), $4)
+    pending = ""
+    next
+}
+# Long input section names wrap, with address, size and file on the next line
+/^ [.A-Z]/ && NF == 1 {
+    pending = $1
+    next
+}
+pending != "" && NF >= 3 && $1 ~ /^0x/ && $2 ~ /^0x/ {
+    add(pending, hex($2), $3)
+    pending = ""
+    next
+}
+{ pending = "" }
+
+END {
+    printf "%-16s %8s %8s %8s %8s %8s\n", "feature", "text", "data", "bss", "flash", "ram"
+    n = 0
+    for (f in features) order[++n] = f
+    for (i = 1; i <= n; i++)
+        for (j = i + 1; j <= n; j++)
+            if (total[order[j], "text"] + total[order[j], "data"] > total[order[i], "text"] + total[order[i], "data"]) {
+                t = order[i]; order[i] = order[j]; order[j] = t
+            }
+    for (i = 1; i <= n; i++) {
+        f = order[i]
+        t = total[f, "text"]; d = total[f, "data"]; b = total[f, "bss"]
+        printf "%-16s %8d %8d %8d %8d %8d\n", f, t, d, b, t + d, d + b
+        flash += t + d
+        ram += d + b
+    }
+    printf "%-16s %8s %8s %8s %8d %8d\n", "total", "", "", "", flash, ram
+
+    printf "\n%-40s %8s %8s\n", "userspace symbol", "flash", "ram"
+    n = 0
+    for (s in symnames) sorder[++n] = s
+    for (i = 1; i <= n; i++)
+        for (j = i + 1; j <= n; j++) {
+            a = symbols[sorder[i], "text"] + symbols[sorder[i], "data"] + symbols[sorder[i], "bss"]
+            c = symbols[sorder[j], "text"] + symbols[sorder[j], "data"] + symbols[sorder[j], "bss"]
+            if (c > a) { t = sorder[i]; sorder[i] = sorder[j]; sorder[j] = t }
+        }
+    for (i = 1; i <= n; i++) {
+        s = sorder[i]
+        printf "%-40s %8d %8d\n", s, symbols[s, "text"] + symbols[s, "data"], symbols[s, "data"] + symbols[s, "bss"]
+    }
+
+    status = 0
+    printf "\n"
+    if (flash_budget != "") {
+        printf "flash: %d / %d bytes%s\n", flash, flash_budget, (flash > flash_budget + 0) ? "  OVER BUDGET" : ""
+        if (flash > flash_budget + 0) status = 1
+    }
+    if (ram_budget != "") {
+        printf "ram:   %d / %d bytes%s\n", ram, ram_budget, (ram > ram_budget + 0) ? "  OVER BUDGET" : ""
+        if (ram > ram_budget + 0) status = 1
+    }
+    exit status
+}
+' "$MAP_FILE"
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# Copyright 2026 thirteen37
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Read Miryoku instrumentation from a running keyboard over raw HID.
+
+usage: miryoku_hid.py [--vid VID] [--pid PID] recorder [--follow]
+       miryoku_hid.py [--vid VID] [--pid PID] profiler [--reset]
+       miryoku_hid.py [--vid VID] [--pid PID] telemetry [--hist] [--reset]
+
+Requires the `hid` package (pip install hid) and firmware built with the
+matching MIRYOKU_* option.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import hid
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE = 0x61
+REPORT_SIZE = 32
+
+HID_RECORDER = 0x01
+HID_PROFILER = 0x02
+HID_TELEMETRY = 0x03
+HID_UNHANDLED = 0xFF
+
+RECORDER_INFO = 0x00
+RECORDER_READ = 0x01
+RECORDER_EVENT = struct.Struct("<IHHBBBB")
+RECORDER_FLAGS = ((0x01, "down"), (0x02, "tap"), (0x04, "hold"), (0x08, "int"))
+
+PROFILER_INFO = 0x00
+PROFILER_READ = 0x01
+PROFILER_RESET = 0x02
+PROFILER_SLOTS = ("loop", "scan", "process", "encoder", "rgb", "deferred", "housekeeping", "tick")
+
+TELEMETRY_INFO = 0x00
+TELEMETRY_READ = 0x01
+TELEMETRY_HIST = 0x02
+TELEMETRY_RESET = 0x03
+TELEMETRY_PATHS = ("tap", "timeout", "permissive", "chordal", "flow", "rollback", "cross_hand")
+
+
+def open_device(vid, pid):
+    for info in hid.enumerate(vid or 0, pid or 0):
+        if info["usage_page"] == RAW_USAGE_PAGE and info["usage"] == RAW_USAGE:
+            return hid.Device(path=info["path"])
+    sys.exit("miryoku_hid: no raw HID interface found")
+
+
+def request(device, command, payload=b""):
+    report = bytes([command]) + payload
+    # Leading 0 is the report ID
+    device.write(b"\x00" + report.ljust(REPORT_SIZE, b"\x00"))
+    reply = device.read(REPORT_SIZE, 1000)
+    if not reply:
+        sys.exit("miryoku_hid: no reply from keyboard")
+    if reply[0] == HID_UNHANDLED:
+        sys.exit("miryoku_hid: command not enabled in firmware")
+    return reply
+
+
+def recorder(device, args):
+    head, size = struct.unpack_from("<HH", request(device, HID_RECORDER, bytes([RECORDER_INFO])), 2)
+    seq = head if args.follow else max(head - size, 0)
+    while True:
+        reply = request(device, HID_RECORDER, struct.pack("<BH", RECORDER_READ, seq))
+        head, count = struct.unpack_from("<HB", reply, 2)
+        if count == 0 and (head - seq) & 0xFFFF:
+            # Fell behind the ring, skip to the oldest event still held
+            seq = (head - size) & 0xFFFF
+            continue
+        for i in range(count):
+            time_us, keycode, delay, row, col, layer, flags = RECORDER_EVENT.unpack_from(reply, 5 + i * RECORDER_EVENT.size)
+            names = ",".join(name for bit, name in RECORDER_FLAGS if flags & bit) or "up"
+            print(f"{seq:5d} {time_us:10d}us  0x{keycode:04X}  r{row}c{col}  L{layer}  {delay:3d}ms  {names}")
+            seq = (seq + 1) & 0xFFFF
+        if count == 0:
+            if not args.follow:
+                return
+            time.sleep(0.05)
+
+
+def profiler(device, args):
+    if args.reset:
+        request(device, HID_PROFILER, bytes([PROFILER_RESET]))
+        return
+    reply = request(device, HID_PROFILER, bytes([PROFILER_INFO]))
+    slots = reply[2]
+    ticks_per_us = struct.unpack_from("<I", reply, 3)[0] / 1000
+    print(f"{'task':<14}{'count':>10}{'min':>10}{'avg':>10}{'p99<=':>10}{'max':>10}  (us)")
+    for slot in range(slots):
+        reply = request(device, HID_PROFILER, bytes([PROFILER_READ, slot]))
+        count, *spans = struct.unpack_from("<5I", reply, 3)
+        if count == 0:
+            continue
+        name = PROFILER_SLOTS[slot] if slot < len(PROFILER_SLOTS) else str(slot)
+        print(f"{name:<14}{count:>10}" + "".join(f"{span / ticks_per_us:>10.1f}" for span in spans))
+
+
+def telemetry(device, args):
+    if args.reset:
+        request(device, HID_TELEMETRY, bytes([TELEMETRY_RESET]))
+        return
+    keys, paths, buckets, bucket_ms = struct.unpack_from("<BBBH", request(device, HID_TELEMETRY, bytes([TELEMETRY_INFO])), 2)
+    names = [TELEMETRY_PATHS[path] if path < len(TELEMETRY_PATHS) else str(path) for path in range(paths)]
+    print(f"{'keycode':<8}" + "".join(f"{name:>11}" for name in names))
+    for key in range(keys):
+        reply = request(device, HID_TELEMETRY, bytes([TELEMETRY_READ, key]))
+        keycode, *counts = struct.unpack_from(f"<H{paths}H", reply, 3)
+        if keycode == 0:
+            break
+        print(f"0x{keycode:04X}  " + "".join(f"{count:>11}" for count in counts))
+        if not args.hist:
+            continue
+        for path in range(paths):
+            if counts[path] == 0:
+                continue
+            reply = request(device, HID_TELEMETRY, bytes([TELEMETRY_HIST, key, path]))
+            hist = struct.unpack_from(f"<{buckets}H", reply, 4)
+            print(f"  {names[path]:<11}" + " ".join(f"{bucket * bucket_ms:>3}+:{count}" for bucket, count in enumerate(hist) if count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--vid", type=lambda x: int(x, 0))
+    parser.add_argument("--pid", type=lambda x: int(x, 0))
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    parser_recorder = commands.add_parser("recorder", help="dump the keystroke recorder")
+    parser_recorder.add_argument("--follow", action="store_true", help="keep printing new events")
+    parser_recorder.set_defaults(func=recorder)
+
+    parser_profiler = commands.add_parser("profiler", help="show main loop task timings")
+    parser_profiler.add_argument("--reset", action="store_true", help="clear the timings")
+    parser_profiler.set_defaults(func=profiler)
+
+    parser_telemetry = commands.add_parser("telemetry", help="show tap-hold decision counters")
+    parser_telemetry.add_argument("--hist", action="store_true", help="also show decision latency histograms (ms)")
+    parser_telemetry.add_argument("--reset", action="store_true", help="clear the counters")
+    parser_telemetry.set_defaults(func=telemetry)
+
+    args = parser.parse_args()
+    args.func(open_device(args.vid, args.pid), args)
+
+
+if __name__ == "__main__":
+    main()